@@ -1,18 +1,21 @@
 #include "catch.hpp"
+#include "eytzinger.hpp"
+#include "tables.hpp"
 #include <algorithm>
+#include <array>
+#include <numeric>
+#include <string_view>
 #include <tuple>
 #include <optional>
 #include <iostream>
+#include <vector>
 
 using namespace std::literals;
 
 template <size_t N>
 constexpr auto create_array()
 {
-    std::array<int, N> arr{};
-    std::iota(arr.begin(), arr.end(), 1);
-
-    return arr;
+    return tables::make_table<N>([](size_t i) { return static_cast<int>(i) + 1; });
 }
 
 TEST_CASE("constexpr algorithms")
@@ -26,23 +29,59 @@ TEST_CASE("constexpr algorithms")
     }();
     
     static_assert(*std::upper_bound(begin(squares), end(squares), 50) == 64);        
+    static_assert(*eytzinger_array{squares}.upper_bound(50) == 64);
 
     constexpr auto sum = std::accumulate(begin(squares), end(squares), 0);
 
     static_assert(sum == 385);        
 }
 
-// constexpr auto tokenize(std::string_view text)
-// {
-//     std::vector<std::string_view> tokens;
-//     return 
-// }
+// transient allocation - the vector lives only during the constant evaluation
+constexpr std::vector<std::string_view> split(std::string_view text, std::string_view delimiters)
+{
+    std::vector<std::string_view> tokens;
+
+    for (auto start = text.find_first_not_of(delimiters); start != std::string_view::npos; start = text.find_first_not_of(delimiters, start))
+    {
+        auto end = std::min(text.find_first_of(delimiters, start), text.size());
+        tokens.push_back(text.substr(start, end - start));
+        start = end;
+    }
+
+    return tokens;
+}
 
-// TEST_CASE("constexpr tokenizing")
-// {
-//     constexpr auto text = "one two,three"sv;
+constexpr std::string_view default_delimiters = " ,";
 
-//     constexpr std::array tokens = tokenize(text);
+// two-phase evaluation: the first one sizes the array, the second one fills it
+//   * Text & Delimiters are references to constants with static storage duration
+//   * tokens are views of Text - nothing is evaluated at runtime
+template <const std::string_view& Text, const std::string_view& Delimiters = default_delimiters>
+consteval auto tokenize()
+{
+    constexpr size_t size = split(Text, Delimiters).size();
+
+    std::array<std::string_view, size> tokens{};
+    std::ranges::copy(split(Text, Delimiters), tokens.begin());
+
+    return tokens;
+}
 
-//     REQUIRE(tokens == std::array{"one"sv, "two"sv, "three"sv);
-// }
\ No newline at end of file
+constexpr auto text = "one two,three"sv;
+
+constexpr auto config_keys = "host;port;timeout;;retries"sv;
+constexpr auto semicolon = ";"sv;
+
+TEST_CASE("constexpr tokenizing")
+{
+    constexpr std::array tokens = tokenize<text>();
+
+    static_assert(tokens == std::array{"one"sv, "two"sv, "three"sv});
+
+    constexpr std::array keys = tokenize<config_keys, semicolon>();
+
+    static_assert(keys.size() == 4);
+    static_assert(keys.back() == "retries"sv);
+
+    REQUIRE(std::ranges::find(keys, "timeout"sv) != keys.end());
+}
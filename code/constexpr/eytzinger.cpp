@@ -0,0 +1,119 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "eytzinger.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    template <typename Layout>
+    void check_against_std(const std::vector<int>& sorted)
+    {
+        const Layout layout{sorted};
+        REQUIRE(layout.size() == sorted.size());
+
+        for (int value = -1; value <= (sorted.empty() ? 0 : sorted.back() + 1); ++value)
+        {
+            CAPTURE(sorted.size(), value);
+
+            const auto lower = std::ranges::lower_bound(sorted, value);
+            const int* found_lower = layout.lower_bound(value);
+            REQUIRE((found_lower == nullptr) == (lower == sorted.end()));
+            if (found_lower)
+                REQUIRE(*found_lower == *lower);
+
+            const auto upper = std::ranges::upper_bound(sorted, value);
+            const int* found_upper = layout.upper_bound(value);
+            REQUIRE((found_upper == nullptr) == (upper == sorted.end()));
+            if (found_upper)
+                REQUIRE(*found_upper == *upper);
+        }
+    }
+}
+
+TEST_CASE("eytzinger_array & s_tree")
+{
+    SECTION("built during the constant evaluation")
+    {
+        constexpr std::array squares{1, 4, 9, 16, 25, 36, 49, 64, 81, 100};
+
+        static_assert(*eytzinger_array{squares}.upper_bound(50) == 64);
+        static_assert(*eytzinger_array{squares}.lower_bound(49) == 49);
+        static_assert(eytzinger_array{squares}.upper_bound(100) == nullptr);
+
+        static_assert(*s_tree{squares}.upper_bound(50) == 64);
+        static_assert(*s_tree{squares}.lower_bound(0) == 1);
+        static_assert(s_tree{squares}.lower_bound(101) == nullptr);
+    }
+
+    SECTION("same answers as std::lower_bound & std::upper_bound")
+    {
+        std::mt19937 rnd{665};
+        std::uniform_int_distribution<int> step{0, 2}; // duplicates & gaps
+
+        for (std::size_t size : {0, 1, 2, 3, 15, 16, 17, 100, 255, 256, 257, 1000, 4913})
+        {
+            std::vector<int> sorted(size);
+            int value = 0;
+            for (auto& item : sorted)
+                item = value += step(rnd);
+
+            check_against_std<eytzinger_array<int>>(sorted);
+            check_against_std<s_tree<int>>(sorted);
+        }
+    }
+}
+
+TEST_CASE("eytzinger_array & s_tree - benchmarks", "[.][benchmark]")
+{
+    std::mt19937 rnd{665};
+
+    // 1G elements (4 GB per copy) do not fit next to three layouts - the largest array is 64M elements
+    for (std::size_t size : {1u << 10, 1u << 16, 1u << 20, 1u << 23, 1u << 26})
+    {
+        std::vector<int> sorted(size);
+        for (std::size_t i = 0; i < size; ++i)
+            sorted[i] = static_cast<int>(2 * i);
+
+        const eytzinger_array<int> eytzinger{sorted};
+        const s_tree<int> btree{sorted};
+
+        std::vector<int> queries(10'000);
+        std::uniform_int_distribution<int> distr{0, static_cast<int>(2 * size)};
+        for (auto& query : queries)
+            query = distr(rnd);
+
+        const std::string suffix = " - " + std::to_string(size) + " elements";
+
+        BENCHMARK("10'000 upper_bounds - std::upper_bound" + suffix)
+        {
+            std::int64_t sum = 0;
+            for (int query : queries)
+                if (auto it = std::upper_bound(sorted.begin(), sorted.end(), query); it != sorted.end())
+                    sum += *it;
+            return sum;
+        };
+
+        BENCHMARK("10'000 upper_bounds - eytzinger_array" + suffix)
+        {
+            std::int64_t sum = 0;
+            for (int query : queries)
+                if (const int* found = eytzinger.upper_bound(query))
+                    sum += *found;
+            return sum;
+        };
+
+        BENCHMARK("10'000 upper_bounds - s_tree" + suffix)
+        {
+            std::int64_t sum = 0;
+            for (int query : queries)
+                if (const int* found = btree.upper_bound(query))
+                    sum += *found;
+            return sum;
+        };
+    }
+}
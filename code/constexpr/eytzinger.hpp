@@ -0,0 +1,237 @@
+#ifndef CONSTEXPR_EYTZINGER_HPP
+#define CONSTEXPR_EYTZINGER_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace detail
+{
+    inline constexpr std::size_t cache_line_size = 64;
+
+    // cache line aligned storage at runtime - std::allocator during the constant evaluation
+    template <typename T>
+    struct CacheAlignedAllocator
+    {
+        using value_type = T;
+
+        static constexpr std::align_val_t alignment{std::max(cache_line_size, alignof(T))};
+
+        CacheAlignedAllocator() = default;
+
+        template <typename U>
+        constexpr CacheAlignedAllocator(const CacheAlignedAllocator<U>&) noexcept
+        {
+        }
+
+        constexpr T* allocate(std::size_t n)
+        {
+            if (std::is_constant_evaluated())
+                return std::allocator<T>{}.allocate(n);
+            return static_cast<T*>(::operator new(n * sizeof(T), alignment));
+        }
+
+        constexpr void deallocate(T* ptr, std::size_t n) noexcept
+        {
+            if (std::is_constant_evaluated())
+                return std::allocator<T>{}.deallocate(ptr, n);
+            ::operator delete(ptr, n * sizeof(T), alignment);
+        }
+
+        bool operator==(const CacheAlignedAllocator&) const = default;
+    };
+
+    // hint only - the address may lie past the end of the array (prefetch never faults)
+    template <typename T>
+    inline void prefetch(const T* base, std::size_t index) noexcept
+    {
+#if defined(__GNUC__)
+        __builtin_prefetch(reinterpret_cast<const void*>(reinterpret_cast<std::uintptr_t>(base) + index * sizeof(T)));
+#endif
+    }
+
+    // in-order walk of the implicit tree (children of k are 2k & 2k + 1) - copies sorted[i...] into layout[k]
+    template <typename Sorted, typename Layout>
+    constexpr std::size_t eytzinger_fill(const Sorted& sorted, Layout& layout, std::size_t i = 0, std::size_t k = 1)
+    {
+        if (k <= std::size(sorted))
+        {
+            i = eytzinger_fill(sorted, layout, i, 2 * k);
+            layout[k] = sorted[i++];
+            i = eytzinger_fill(sorted, layout, i, 2 * k + 1);
+        }
+        return i;
+    }
+
+    // descent of the 1-based Eytzinger layout of n elements - turns right while go_right(element)
+    //   * returns the index of the first element the descent did not turn right at - 0 if there is none
+    //   * the comparison only picks the child - there is no data-dependent branch
+    //   * Prefetch - the descendants of k one cache line deeper are loaded ahead (pays off once the layout leaves L1)
+    template <bool Prefetch, typename T, typename GoRight>
+    constexpr std::size_t eytzinger_search(const T* layout, std::size_t n, GoRight go_right) noexcept
+    {
+        constexpr std::size_t prefetch_stride = std::bit_floor(std::max(cache_line_size / sizeof(T), std::size_t{1}));
+
+        std::size_t k = 1;
+        while (k <= n)
+        {
+            if (Prefetch && !std::is_constant_evaluated())
+                prefetch(layout, k * prefetch_stride);
+            k = 2 * k + static_cast<std::size_t>(go_right(layout[k]));
+        }
+
+        // the last left turn of the descent is the answer - drop the trailing right turns & that turn
+        return k >> (std::countr_one(k) + 1);
+    }
+}
+
+//////////////////////////////////////////////////////////////////
+// eytzinger_array<T> - sorted values in the Eytzinger (BFS) layout
+//   constexpr auto first_above = *eytzinger_array{squares}.upper_bound(50);
+//   * the first levels of every search share the same cache lines & the next ones are prefetched
+//   * buildable at runtime or (transiently) during the constant evaluation
+//   * the input has to be sorted - T needs operator< & a default constructor
+template <typename T>
+class eytzinger_array
+{
+    std::vector<T, detail::CacheAlignedAllocator<T>> layout_; // 1-based, layout_[0] is unused
+
+public:
+    using value_type = T;
+
+    constexpr explicit eytzinger_array(std::span<const T> sorted)
+        : layout_(sorted.size() + 1)
+    {
+        detail::eytzinger_fill(sorted, layout_);
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+        return layout_.size() - 1;
+    }
+
+    // the first element not less than value - nullptr if there is none
+    template <typename U>
+    constexpr const T* lower_bound(const U& value) const noexcept
+    {
+        return at(detail::eytzinger_search<true>(layout_.data(), size(), [&value](const T& item) { return item < value; }));
+    }
+
+    // the first element greater than value - nullptr if there is none
+    template <typename U>
+    constexpr const T* upper_bound(const U& value) const noexcept
+    {
+        return at(detail::eytzinger_search<true>(layout_.data(), size(), [&value](const T& item) { return !(value < item); }));
+    }
+
+private:
+    constexpr const T* at(std::size_t k) const noexcept
+    {
+        return k != 0 ? &layout_[k] : nullptr;
+    }
+};
+
+template <std::ranges::contiguous_range R>
+eytzinger_array(R&&) -> eytzinger_array<std::ranges::range_value_t<R>>;
+
+//////////////////////////////////////////////////////////////////
+// s_tree<T> - static B-tree: sorted values in nodes of one cache line
+//   * node k has node_size + 1 children: k * (node_size + 1) + 1, ..., k * (node_size + 1) + node_size + 1
+//   * a search reads one cache line per level - log(node_size + 1) times fewer than a binary search
+//   * the rank inside a node is counted without early exit - the loop is vectorized
+//   * slots past the n values (in-order positions n, n + 1, ... - spread over any nodes) hold copies of the greatest value
+template <typename T>
+class s_tree
+{
+public:
+    using value_type = T;
+
+    static constexpr std::size_t node_size = std::max(detail::cache_line_size / sizeof(T), std::size_t{2});
+
+private:
+    std::vector<T, detail::CacheAlignedAllocator<T>> keys_; // node k is keys_[k * node_size, (k + 1) * node_size)
+    std::size_t size_;
+    std::size_t node_count_;
+
+public:
+    constexpr explicit s_tree(std::span<const T> sorted)
+        : size_{sorted.size()}
+        , node_count_{(sorted.size() + node_size - 1) / node_size}
+    {
+        keys_.resize(node_count_ * node_size);
+
+        std::size_t i = 0;
+        fill(sorted, i, 0);
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    // the first element not less than value - nullptr if there is none
+    template <typename U>
+    constexpr const T* lower_bound(const U& value) const noexcept
+    {
+        return search([&value](const T& item) { return item < value; });
+    }
+
+    // the first element greater than value - nullptr if there is none
+    template <typename U>
+    constexpr const T* upper_bound(const U& value) const noexcept
+    {
+        return search([&value](const T& item) { return !(value < item); });
+    }
+
+private:
+    static constexpr std::size_t child(std::size_t k, std::size_t i) noexcept
+    {
+        return k * (node_size + 1) + i + 1;
+    }
+
+    constexpr void fill(std::span<const T> sorted, std::size_t& i, std::size_t k)
+    {
+        if (k >= node_count_)
+            return;
+
+        for (std::size_t j = 0; j < node_size; ++j)
+        {
+            fill(sorted, i, child(k, j));
+            keys_[k * node_size + j] = i < sorted.size() ? sorted[i++] : sorted.back();
+        }
+        fill(sorted, i, child(k, node_size));
+    }
+
+    template <typename GoRight>
+    constexpr const T* search(GoRight go_right) const noexcept
+    {
+        const T* result = nullptr;
+
+        for (std::size_t k = 0; k < node_count_;)
+        {
+            const T* node = keys_.data() + k * node_size;
+
+            std::size_t rank = 0;
+            for (std::size_t j = 0; j < node_size; ++j)
+                rank += static_cast<std::size_t>(go_right(node[j]));
+
+            if (rank < node_size)
+                result = node + rank;
+            k = child(k, rank);
+        }
+
+        return result;
+    }
+};
+
+template <std::ranges::contiguous_range R>
+s_tree(R&&) -> s_tree<std::ranges::range_value_t<R>>;
+
+#endif //CONSTEXPR_EYTZINGER_HPP
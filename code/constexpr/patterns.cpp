@@ -0,0 +1,144 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "patterns.hpp"
+#include <fstream>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::literals;
+
+namespace
+{
+    std::vector<std::string> load_dictionary()
+    {
+        std::ifstream fin{"en.dict"};
+
+        std::vector<std::string> dictionary;
+        std::string word;
+
+        while (fin >> word)
+            dictionary.push_back(std::move(word));
+
+        return dictionary;
+    }
+
+    // every string over the alphabet up to max_length
+    std::vector<std::string> all_strings(std::string_view alphabet, std::size_t max_length)
+    {
+        std::vector<std::string> strings{""};
+        for (std::size_t begin = 0, length = 0; length < max_length; ++length)
+        {
+            const std::size_t end = strings.size();
+            for (std::size_t i = begin; i < end; ++i)
+                for (char c : alphabet)
+                    strings.push_back(strings[i] + c);
+            begin = end;
+        }
+        return strings;
+    }
+
+    template <Str Pattern>
+    void check_against_std_regex(const std::vector<std::string>& texts)
+    {
+        const std::regex regex{std::string{Pattern.view()}};
+
+        for (const auto& text : texts)
+        {
+            CAPTURE(Pattern.view(), text);
+            REQUIRE(patterns::match<Pattern>(text) == std::regex_match(text, regex));
+        }
+    }
+}
+
+TEST_CASE("patterns - compile-time DFA")
+{
+    SECTION("matching at compile time")
+    {
+        static_assert(patterns::match<"hello">("hello"));
+        static_assert(!patterns::match<"hello">("hell"));
+        static_assert(!patterns::match<"hello">("hello!"));
+
+        static_assert(patterns::match<"">(""));
+        static_assert(!patterns::match<"">("a"));
+
+        static_assert(patterns::match<"colou?r">("color") && patterns::match<"colou?r">("colour"));
+        static_assert(patterns::match<"(ab)+c*">("ababcc") && !patterns::match<"(ab)+c*">("c"));
+        static_assert(patterns::match<"[a-z]+ing">("string") && !patterns::match<"[a-z]+ing">("ing"));
+        static_assert(patterns::match<"ERROR|WARN(ING)?">("WARNING") && !patterns::match<"ERROR|WARN(ING)?">("WARN "));
+        static_assert(patterns::match<"[^0-9]*">("abc") && !patterns::match<"[^0-9]*">("a1"));
+        static_assert(patterns::match<"\\d+\\.\\d+">("3.14") && !patterns::match<"\\d+\\.\\d+">("3x14"));
+        static_assert(patterns::match<"a.c">("abc") && !patterns::match<"a.c">("a\nc"));
+        static_assert(patterns::match<Str{"[-+]?\\d+"}>("-42"));
+        static_assert(patterns::match<"x{2,3}">("xxx") && !patterns::match<"x{2,3}">("x") && !patterns::match<"x{2,3}">("xxxx"));
+    }
+
+    SECTION("the DFA is small")
+    {
+        constexpr auto& words_ending_with_ing = patterns::dfa<"[a-z]+ing">;
+
+        static_assert(words_ending_with_ing.state_count() == 6); // dead, start, [a-z]+, i, n, g
+        static_assert(words_ending_with_ing.class_count() == 5); // i, n, g, other letters, other bytes
+    }
+
+    SECTION("log tokens")
+    {
+        constexpr auto is_ipv4 = [](std::string_view token) { return patterns::match<"(\\d{1,3}\\.){3}\\d{1,3}">(token); };
+        constexpr auto is_timestamp = [](std::string_view token) { return patterns::match<"\\d{4}-\\d\\d-\\d\\dT\\d\\d:\\d\\d:\\d\\d(\\.\\d+)?Z">(token); };
+
+        REQUIRE(is_ipv4("192.168.0.1"));
+        REQUIRE_FALSE(is_ipv4("192.168.0"));
+        REQUIRE_FALSE(is_ipv4("1921.168.0.1"));
+        REQUIRE(is_timestamp("2023-02-14T12:30:00.125Z"));
+        REQUIRE_FALSE(is_timestamp("2023-02-14 12:30:00"));
+    }
+
+    SECTION("same answers as std::regex_match")
+    {
+        const auto texts = all_strings("abc.", 5);
+
+        check_against_std_regex<"a*b">(texts);
+        check_against_std_regex<"(a|b)*abb">(texts);
+        check_against_std_regex<"(a|bc)+.?">(texts);
+        check_against_std_regex<"[ab]*c|a.b">(texts);
+        check_against_std_regex<"((a|)b)*\\.">(texts);
+        check_against_std_regex<"[^a]?(b+|c+)*a">(texts);
+        check_against_std_regex<"[a-b.]+c?">(texts);
+        check_against_std_regex<"a{2}b{0,2}">(texts);
+        check_against_std_regex<"(ab|c){1,}a?">(texts);
+        check_against_std_regex<"[ab]{2,3}c*{2}">(texts);
+    }
+}
+
+TEST_CASE("patterns - benchmarks", "[.][benchmark]")
+{
+    const std::vector<std::string> dictionary = load_dictionary();
+    REQUIRE(dictionary.size() > 100'000);
+
+    const std::regex words_ending_with_ing{"[a-z]+ing"};
+    const std::regex prefixed_adjectives{"(un|re|dis)[a-z]*(able|ible)"};
+
+    REQUIRE(std::ranges::count_if(dictionary, [](const auto& word) { return patterns::match<"[a-z]+ing">(word); })
+        == std::ranges::count_if(dictionary, [&](const auto& word) { return std::regex_match(word, words_ending_with_ing); }));
+
+    BENCHMARK("en.dict - [a-z]+ing - patterns::match")
+    {
+        return std::ranges::count_if(dictionary, [](const auto& word) { return patterns::match<"[a-z]+ing">(word); });
+    };
+
+    BENCHMARK("en.dict - [a-z]+ing - std::regex_match")
+    {
+        return std::ranges::count_if(dictionary, [&](const auto& word) { return std::regex_match(word, words_ending_with_ing); });
+    };
+
+    BENCHMARK("en.dict - (un|re|dis)[a-z]*(able|ible) - patterns::match")
+    {
+        return std::ranges::count_if(dictionary, [](const auto& word) { return patterns::match<"(un|re|dis)[a-z]*(able|ible)">(word); });
+    };
+
+    BENCHMARK("en.dict - (un|re|dis)[a-z]*(able|ible) - std::regex_match")
+    {
+        return std::ranges::count_if(dictionary, [&](const auto& word) { return std::regex_match(word, prefixed_adjectives); });
+    };
+}
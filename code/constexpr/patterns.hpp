@@ -0,0 +1,492 @@
+#ifndef CONSTEXPR_PATTERNS_HPP
+#define CONSTEXPR_PATTERNS_HPP
+
+#include "str.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace patterns
+{
+    namespace detail
+    {
+        // set of bytes
+        struct CharSet
+        {
+            std::array<std::uint64_t, 4> bits{};
+
+            constexpr void insert(unsigned char c) noexcept
+            {
+                bits[c / 64] |= std::uint64_t{1} << (c % 64);
+            }
+
+            constexpr void insert(unsigned char first, unsigned char last) noexcept
+            {
+                for (unsigned c = first; c <= last; ++c)
+                    insert(static_cast<unsigned char>(c));
+            }
+
+            constexpr void insert(const CharSet& other) noexcept
+            {
+                for (std::size_t i = 0; i < bits.size(); ++i)
+                    bits[i] |= other.bits[i];
+            }
+
+            constexpr bool contains(unsigned char c) const noexcept
+            {
+                return (bits[c / 64] >> (c % 64)) & 1;
+            }
+
+            constexpr CharSet complement() const noexcept
+            {
+                CharSet result;
+                for (std::size_t i = 0; i < bits.size(); ++i)
+                    result.bits[i] = ~bits[i];
+                return result;
+            }
+        };
+
+        using Positions = std::vector<std::size_t>; // sorted indexes of pattern leaves
+
+        constexpr void merge_into(Positions& target, const Positions& source)
+        {
+            Positions merged;
+            std::set_union(target.begin(), target.end(), source.begin(), source.end(), std::back_inserter(merged));
+            target = std::move(merged);
+        }
+
+        // subexpression summary of the position automaton (Glushkov)
+        struct Node
+        {
+            bool nullable;
+            Positions first;
+            Positions last;
+        };
+
+        //////////////////////////////////////////////////////////////////
+        // Parser - recursive descent over the pattern, computes followpos of every leaf
+        //   alternation := concatenation ('|' concatenation)*
+        //   concatenation := repetition*
+        //   repetition := atom ('*' | '+' | '?' | '{' m (',' n?)? '}')*
+        //   atom := '(' alternation ')' | '[' '^'? class ']' | '.' | '\' escape | literal
+        class Parser
+        {
+            std::string_view pattern_;
+            std::size_t pos_ = 0;
+
+        public:
+            std::vector<CharSet> chars;     // bytes matched by every position
+            std::vector<Positions> follow; // positions that may follow every position
+
+            constexpr explicit Parser(std::string_view pattern)
+                : pattern_{pattern}
+            {
+            }
+
+            constexpr Node parse()
+            {
+                Node root = alternation();
+                if (pos_ != pattern_.size())
+                    throw std::invalid_argument("unbalanced ')' in pattern");
+                return root;
+            }
+
+            constexpr Node leaf(const CharSet& set)
+            {
+                chars.push_back(set);
+                follow.emplace_back();
+                return Node{false, {chars.size() - 1}, {chars.size() - 1}};
+            }
+
+            constexpr Node concatenate(Node left, const Node& right)
+            {
+                for (std::size_t p : left.last)
+                    merge_into(follow[p], right.first);
+
+                if (left.nullable)
+                    merge_into(left.first, right.first);
+                if (right.nullable)
+                    merge_into(left.last, right.last);
+                else
+                    left.last = right.last;
+                left.nullable = left.nullable && right.nullable;
+
+                return left;
+            }
+
+        private:
+            constexpr bool at_end() const noexcept
+            {
+                return pos_ == pattern_.size();
+            }
+
+            constexpr char peek() const noexcept
+            {
+                return pattern_[pos_];
+            }
+
+            constexpr Node alternation()
+            {
+                Node result = concatenation();
+                while (!at_end() && peek() == '|')
+                {
+                    ++pos_;
+                    const Node alternative = concatenation();
+                    merge_into(result.first, alternative.first);
+                    merge_into(result.last, alternative.last);
+                    result.nullable = result.nullable || alternative.nullable;
+                }
+                return result;
+            }
+
+            constexpr Node concatenation()
+            {
+                Node result{true, {}, {}};
+                while (!at_end() && peek() != '|' && peek() != ')')
+                    result = concatenate(std::move(result), repetition());
+                return result;
+            }
+
+            // stop - the end of a unit re-parsed for a counted repetition
+            constexpr Node repetition(std::size_t stop = std::string_view::npos)
+            {
+                const std::size_t begin = pos_;
+                Node result = atom();
+                while (pos_ < stop && !at_end() && (peek() == '*' || peek() == '+' || peek() == '?' || peek() == '{'))
+                {
+                    const char op = pattern_[pos_];
+                    if (op == '{')
+                    {
+                        result = counted(std::move(result), begin);
+                        continue;
+                    }
+
+                    ++pos_;
+                    if (op != '?')
+                        loop(result);
+                    if (op != '+')
+                        result.nullable = true;
+                }
+                return result;
+            }
+
+            constexpr void loop(Node& node)
+            {
+                for (std::size_t p : node.last)
+                    merge_into(follow[p], node.first);
+            }
+
+            // x{m}, x{m,}, x{m,n} - every extra copy of x is parsed again from [begin, '{') & gets its own positions
+            constexpr Node counted(Node first_copy, std::size_t begin)
+            {
+                const std::size_t end = pos_++;
+                const std::size_t min = number();
+                std::size_t max = min;
+                bool unbounded = false;
+                if (!at_end() && peek() == ',')
+                {
+                    ++pos_;
+                    if (!at_end() && peek() == '}')
+                        unbounded = true;
+                    else
+                        max = number();
+                }
+                if (at_end() || peek() != '}')
+                    throw std::invalid_argument("missing '}' in pattern");
+                if (max < min)
+                    throw std::invalid_argument("invalid repetition count in pattern");
+                const std::size_t resume = ++pos_;
+
+                const std::size_t copies = unbounded ? min + 1 : max;
+                Node result{true, {}, {}};
+                for (std::size_t i = 0; i < copies; ++i)
+                {
+                    Node copy{};
+                    if (i == 0)
+                        copy = std::move(first_copy);
+                    else
+                        copy = reparse(begin, end);
+                    if (i >= min)
+                    {
+                        if (unbounded)
+                            loop(copy);
+                        copy.nullable = true;
+                    }
+                    result = concatenate(std::move(result), copy);
+                }
+
+                pos_ = resume;
+                return result;
+            }
+
+            constexpr Node reparse(std::size_t begin, std::size_t end)
+            {
+                pos_ = begin;
+                return repetition(end);
+            }
+
+            constexpr std::size_t number()
+            {
+                if (at_end() || peek() < '0' || peek() > '9')
+                    throw std::invalid_argument("missing repetition count in pattern");
+
+                std::size_t value = 0;
+                while (!at_end() && peek() >= '0' && peek() <= '9')
+                    value = value * 10 + static_cast<std::size_t>(pattern_[pos_++] - '0');
+                return value;
+            }
+
+            constexpr Node atom()
+            {
+                const char c = pattern_[pos_++];
+                switch (c)
+                {
+                    case '(':
+                    {
+                        Node group = alternation();
+                        if (at_end() || peek() != ')')
+                            throw std::invalid_argument("missing ')' in pattern");
+                        ++pos_;
+                        return group;
+                    }
+                    case '[':
+                        return leaf(char_class());
+                    case '.':
+                    {
+                        CharSet line_breaks;
+                        line_breaks.insert('\n');
+                        line_breaks.insert('\r');
+                        return leaf(line_breaks.complement());
+                    }
+                    case '\\':
+                        return leaf(escape());
+                    case '*':
+                    case '+':
+                    case '?':
+                    case '{':
+                        throw std::invalid_argument("nothing to repeat in pattern");
+                    default:
+                    {
+                        CharSet literal;
+                        literal.insert(static_cast<unsigned char>(c));
+                        return leaf(literal);
+                    }
+                }
+            }
+
+            constexpr CharSet escape()
+            {
+                if (at_end())
+                    throw std::invalid_argument("trailing '\\' in pattern");
+
+                CharSet set;
+                switch (const char c = pattern_[pos_++])
+                {
+                    case 'd':
+                        set.insert('0', '9');
+                        break;
+                    case 'w':
+                        set.insert('a', 'z');
+                        set.insert('A', 'Z');
+                        set.insert('0', '9');
+                        set.insert('_');
+                        break;
+                    case 's':
+                        for (char space : {' ', '\t', '\n', '\r', '\f', '\v'})
+                            set.insert(static_cast<unsigned char>(space));
+                        break;
+                    default: // escaped metacharacter
+                        set.insert(static_cast<unsigned char>(c));
+                }
+                return set;
+            }
+
+            // after '[' - ranges a-z, escapes & the leading '^'; '-' is a literal at the edges
+            constexpr CharSet char_class()
+            {
+                CharSet set;
+                const bool negated = !at_end() && peek() == '^';
+                if (negated)
+                    ++pos_;
+
+                for (bool first = true; !at_end() && (first || peek() != ']'); first = false)
+                {
+                    if (peek() == '\\')
+                    {
+                        ++pos_;
+                        set.insert(escape());
+                        continue;
+                    }
+
+                    const auto low = static_cast<unsigned char>(pattern_[pos_++]);
+                    if (pos_ + 1 < pattern_.size() && peek() == '-' && pattern_[pos_ + 1] != ']')
+                    {
+                        const auto high = static_cast<unsigned char>(pattern_[pos_ + 1]);
+                        if (high < low)
+                            throw std::invalid_argument("invalid range in pattern");
+                        set.insert(low, high);
+                        pos_ += 2;
+                    }
+                    else
+                        set.insert(low);
+                }
+
+                if (at_end())
+                    throw std::invalid_argument("missing ']' in pattern");
+                ++pos_;
+
+                return negated ? set.complement() : set;
+            }
+        };
+
+        // transient DFA - state 0 is the dead state, state 1 is the start
+        struct Automaton
+        {
+            std::array<std::uint8_t, 256> classes{}; // bytes no position tells apart share a class
+            std::size_t class_count = 0;
+            std::vector<std::size_t> next;  // next[state * class_count + class]
+            std::vector<char> accepting;
+
+            constexpr std::size_t state_count() const noexcept
+            {
+                return accepting.size();
+            }
+        };
+
+        // subset construction over the position automaton
+        constexpr Automaton build_automaton(std::string_view pattern)
+        {
+            Parser parser{pattern};
+            Node root = parser.parse();
+            const Node end_marker = parser.leaf(CharSet{}); // matches no byte - reaching it accepts
+            const std::size_t accept = end_marker.first.front();
+            root = parser.concatenate(std::move(root), end_marker);
+
+            Automaton automaton;
+
+            std::vector<unsigned char> representatives;
+            for (unsigned c = 0; c < 256; ++c)
+            {
+                const auto same_class = [&parser, c](unsigned char other) {
+                    return std::ranges::all_of(parser.chars, [c, other](const CharSet& set) { return set.contains(c) == set.contains(other); });
+                };
+
+                const auto it = std::ranges::find_if(representatives, same_class);
+                automaton.classes[c] = static_cast<std::uint8_t>(it - representatives.begin());
+                if (it == representatives.end())
+                    representatives.push_back(static_cast<unsigned char>(c));
+            }
+            automaton.class_count = representatives.size();
+
+            std::vector<Positions> states{Positions{}, root.first};
+            for (std::size_t state = 0; state < states.size(); ++state)
+            {
+                const Positions current = states[state]; // states grow in the loop
+                automaton.accepting.push_back(std::ranges::binary_search(current, accept));
+
+                for (unsigned char representative : representatives)
+                {
+                    Positions target;
+                    for (std::size_t p : current)
+                        if (parser.chars[p].contains(representative))
+                            merge_into(target, parser.follow[p]);
+
+                    const auto it = std::ranges::find(states, target);
+                    automaton.next.push_back(static_cast<std::size_t>(it - states.begin()));
+                    if (it == states.end())
+                        states.push_back(std::move(target));
+                }
+            }
+
+            return automaton;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // Dfa<States, Classes> - deterministic automaton of a pattern, built by the compiler
+    //   * one table lookup per byte - no backtracking, no allocation
+    //   * the byte -> class map shrinks the table to States x Classes entries
+    //   * the scan stops at the dead state
+    template <std::size_t States, std::size_t Classes>
+    class Dfa
+    {
+        static_assert(States <= 65536, "pattern produces too many DFA states");
+
+    public:
+        using state_type = std::conditional_t<(States <= 256), std::uint8_t, std::uint16_t>;
+
+    private:
+        static constexpr state_type dead = 0;
+        static constexpr state_type start = 1;
+
+        std::array<std::uint8_t, 256> classes_{};
+        std::array<state_type, States * Classes> next_{};
+        std::array<bool, States> accepting_{};
+
+    public:
+        constexpr explicit Dfa(const detail::Automaton& automaton)
+            : classes_{automaton.classes}
+        {
+            for (std::size_t i = 0; i < next_.size(); ++i)
+                next_[i] = static_cast<state_type>(automaton.next[i]);
+            for (std::size_t state = 0; state < States; ++state)
+                accepting_[state] = automaton.accepting[state];
+        }
+
+        static constexpr std::size_t state_count() noexcept
+        {
+            return States;
+        }
+
+        static constexpr std::size_t class_count() noexcept
+        {
+            return Classes;
+        }
+
+        // the whole text has to match - as std::regex_match
+        constexpr bool match(std::string_view text) const noexcept
+        {
+            state_type state = start;
+            for (char c : text)
+            {
+                state = next_[state * Classes + classes_[static_cast<unsigned char>(c)]];
+                if (state == dead)
+                    return false;
+            }
+            return accepting_[state];
+        }
+    };
+
+    // syntax errors (unbalanced brackets, dangling '*', ...) fail the build
+    template <Str Pattern>
+    consteval auto compile()
+    {
+        constexpr auto sizes = [] {
+            const auto automaton = detail::build_automaton(Pattern.view());
+            return std::array{automaton.state_count(), automaton.class_count};
+        }();
+
+        return Dfa<sizes[0], sizes[1]>{detail::build_automaton(Pattern.view())};
+    }
+
+    template <Str Pattern>
+    inline constexpr auto dfa = compile<Pattern>();
+
+    //////////////////////////////////////////////////////////////////
+    // match<"pattern">(text) - text matches the whole pattern compiled at compile time
+    //   patterns::match<"[a-z]+ing">("string") == true
+    //   * syntax: literals, '.', [a-z] & [^...] classes, \d \w \s, groups, '|', '*', '+', '?', {m,n}
+    template <Str Pattern>
+    constexpr bool match(std::string_view text) noexcept
+    {
+        return dfa<Pattern>.match(text);
+    }
+}
+
+#endif //CONSTEXPR_PATTERNS_HPP
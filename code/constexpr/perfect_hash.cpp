@@ -0,0 +1,111 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "perfect_hash.hpp"
+#include <algorithm>
+#include <array>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std::literals;
+
+namespace
+{
+    constexpr std::array cpp_keywords = {
+        "alignas"sv, "alignof"sv, "and"sv, "and_eq"sv, "asm"sv, "auto"sv, "bitand"sv, "bitor"sv, "bool"sv,
+        "break"sv, "case"sv, "catch"sv, "char"sv, "char8_t"sv, "char16_t"sv, "char32_t"sv, "class"sv, "compl"sv,
+        "concept"sv, "const"sv, "consteval"sv, "constexpr"sv, "constinit"sv, "const_cast"sv, "continue"sv,
+        "co_await"sv, "co_return"sv, "co_yield"sv, "decltype"sv, "default"sv, "delete"sv, "do"sv, "double"sv,
+        "dynamic_cast"sv, "else"sv, "enum"sv, "explicit"sv, "export"sv, "extern"sv, "false"sv, "float"sv, "for"sv,
+        "friend"sv, "goto"sv, "if"sv, "inline"sv, "int"sv, "long"sv, "mutable"sv, "namespace"sv, "new"sv,
+        "noexcept"sv, "not"sv, "not_eq"sv, "nullptr"sv, "operator"sv, "or"sv, "or_eq"sv, "private"sv,
+        "protected"sv, "public"sv, "register"sv, "reinterpret_cast"sv, "requires"sv, "return"sv, "short"sv,
+        "signed"sv, "sizeof"sv, "static"sv, "static_assert"sv, "static_cast"sv, "struct"sv, "switch"sv,
+        "template"sv, "this"sv, "thread_local"sv, "throw"sv, "true"sv, "try"sv, "typedef"sv, "typeid"sv,
+        "typename"sv, "union"sv, "unsigned"sv, "using"sv, "virtual"sv, "void"sv, "volatile"sv, "wchar_t"sv,
+        "while"sv, "xor"sv, "xor_eq"sv};
+
+    constexpr auto keywords = make_perfect_hash(cpp_keywords);
+}
+
+TEST_CASE("perfect hash")
+{
+    SECTION("every key is found at its index")
+    {
+        for (std::size_t i = 0; i < cpp_keywords.size(); ++i)
+        {
+            CAPTURE(cpp_keywords[i]);
+            REQUIRE(keywords.find(cpp_keywords[i]) == i);
+        }
+
+        static_assert(keywords.find("co_await") == 25);
+    }
+
+    SECTION("other strings are not found")
+    {
+        static_assert(!keywords.contains("co_wait"));
+        static_assert(!keywords.contains(""));
+
+        for (auto word : {"Class"sv, "iff"sv, "vector"sv, "constexp"sv, "whilee"sv})
+            REQUIRE(keywords.find(word) == keywords.npos);
+    }
+
+    SECTION("keys as Str template parameters")
+    {
+        constexpr auto commands = make_perfect_hash<Str{"get"}, Str{"set"}, Str{"del"}, Str{"quit"}>();
+
+        static_assert(commands.find("set") == 1);
+        static_assert(commands.find("quit") == 3);
+        static_assert(!commands.contains("sett"));
+
+        // make_perfect_hash<Str{"get"}, Str{"set"}, Str{"get"}>(); // fails the build - duplicated keys
+    }
+}
+
+TEST_CASE("perfect hash - benchmarks", "[.][benchmark]")
+{
+    // source-like stream of identifiers - about a half of them are keywords
+    std::vector<std::string> words;
+    std::mt19937 rnd{665};
+    std::uniform_int_distribution<std::size_t> keyword_index{0, cpp_keywords.size() - 1};
+    for (int i = 0; i < 10'000; ++i)
+    {
+        std::string word{cpp_keywords[keyword_index(rnd)]};
+        if (i % 2)
+            word += "_id";
+        words.push_back(std::move(word));
+    }
+
+    std::unordered_map<std::string_view, std::size_t> hash_map;
+    for (std::size_t i = 0; i < cpp_keywords.size(); ++i)
+        hash_map.emplace(cpp_keywords[i], i);
+
+    std::vector<std::string_view> sorted(cpp_keywords.begin(), cpp_keywords.end());
+    std::ranges::sort(sorted);
+
+    BENCHMARK("10'000 lookups - PerfectHash")
+    {
+        std::size_t found = 0;
+        for (const auto& word : words)
+            found += keywords.contains(word);
+        return found;
+    };
+
+    BENCHMARK("10'000 lookups - std::unordered_map")
+    {
+        std::size_t found = 0;
+        for (const auto& word : words)
+            found += hash_map.contains(word);
+        return found;
+    };
+
+    BENCHMARK("10'000 lookups - binary search in sorted array")
+    {
+        std::size_t found = 0;
+        for (const auto& word : words)
+            found += std::ranges::binary_search(sorted, std::string_view{word});
+        return found;
+    };
+}
@@ -0,0 +1,177 @@
+#ifndef CONSTEXPR_PERFECT_HASH_HPP
+#define CONSTEXPR_PERFECT_HASH_HPP
+
+#include "str.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+
+namespace detail
+{
+    // FNV-1a
+    constexpr std::uint64_t hash(std::string_view key) noexcept
+    {
+        std::uint64_t h = 0xcbf29ce484222325ULL;
+        for (char c : key)
+        {
+            h ^= static_cast<unsigned char>(c);
+            h *= 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+    // splitmix64 finalizer - spreads a displaced hash over the slots
+    constexpr std::uint64_t mix(std::uint64_t x) noexcept
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+}
+
+//////////////////////////////////////////////////////////////////
+// PerfectHash<N> - collision-free table of N strings built at compile time
+//   * hash & displace (CHD): keys are grouped in buckets by the hash, every bucket gets
+//     a displacement that moves all its keys to free slots
+//   * lookup: one hash of the key + one string compare
+//   * find() returns the index of the key in the list passed to make_perfect_hash()
+template <std::size_t N>
+class PerfectHash
+{
+    static_assert(N > 0, "a perfect hash needs at least one key");
+
+public:
+    static constexpr std::size_t npos = N;
+    static constexpr std::size_t bucket_count = (N + 3) / 4;
+    static constexpr std::size_t slot_count = std::bit_ceil(N + N / 4 + 1);
+    static constexpr std::size_t max_bucket_size = 16; // ~4 keys per bucket on average
+
+private:
+    std::array<std::uint32_t, bucket_count> displacements_{};
+    std::array<std::string_view, slot_count> keys_{};
+    std::array<std::uint32_t, slot_count> indices_{}; // npos in free slots
+
+    static constexpr std::size_t bucket_of(std::uint64_t h) noexcept
+    {
+        return (h >> 32) % bucket_count;
+    }
+
+    static constexpr std::size_t slot_of(std::uint64_t h, std::uint32_t displacement) noexcept
+    {
+        return detail::mix(h + displacement * 0x9e3779b97f4a7c15ULL) & (slot_count - 1);
+    }
+
+public:
+    constexpr PerfectHash() = default;
+
+    consteval explicit PerfectHash(const std::array<std::string_view, N>& keys)
+    {
+        std::array<std::string_view, N> sorted_keys = keys;
+        std::sort(sorted_keys.begin(), sorted_keys.end());
+        if (std::adjacent_find(sorted_keys.begin(), sorted_keys.end()) != sorted_keys.end())
+            throw std::invalid_argument("duplicated keys"); // no displacement could separate them
+
+        indices_.fill(npos);
+        keys_.fill(std::string_view{""}); // GCC 12 rejects reads of value-initialized string_views of a constexpr object
+
+        std::array<std::uint64_t, N> hashes{};
+        std::array<std::size_t, bucket_count> bucket_sizes{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            hashes[i] = detail::hash(keys[i]);
+            ++bucket_sizes[bucket_of(hashes[i])];
+        }
+
+        // the largest buckets are placed first - while most of the slots are still free
+        std::array<std::size_t, N> order{};
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            const std::size_t bucket_a = bucket_of(hashes[a]);
+            const std::size_t bucket_b = bucket_of(hashes[b]);
+            if (bucket_sizes[bucket_a] != bucket_sizes[bucket_b])
+                return bucket_sizes[bucket_a] > bucket_sizes[bucket_b];
+            return bucket_a < bucket_b;
+        });
+
+        std::array<bool, slot_count> taken{};
+
+        for (std::size_t first = 0; first < N;)
+        {
+            const std::size_t bucket = bucket_of(hashes[order[first]]);
+            const std::size_t last = first + bucket_sizes[bucket];
+
+            for (std::uint32_t displacement = 0;; ++displacement)
+            {
+                if (displacement == 1'000'000)
+                    throw std::invalid_argument("perfect hash not found");
+
+                std::array<std::size_t, max_bucket_size> slots{};
+                if (last - first > max_bucket_size)
+                    throw std::invalid_argument("bucket too large");
+
+                bool fits = true;
+                for (std::size_t i = first; i < last && fits; ++i)
+                {
+                    slots[i - first] = slot_of(hashes[order[i]], displacement);
+                    fits = !taken[slots[i - first]]
+                        && std::find(slots.begin(), slots.begin() + (i - first), slots[i - first]) == slots.begin() + (i - first);
+                }
+
+                if (!fits)
+                    continue;
+
+                displacements_[bucket] = displacement;
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    taken[slots[i - first]] = true;
+                    keys_[slots[i - first]] = keys[order[i]];
+                    indices_[slots[i - first]] = static_cast<std::uint32_t>(order[i]);
+                }
+                break;
+            }
+
+            first = last;
+        }
+    }
+
+    static constexpr std::size_t size() noexcept
+    {
+        return N;
+    }
+
+    constexpr std::size_t find(std::string_view key) const noexcept
+    {
+        const std::uint64_t h = detail::hash(key);
+        const std::size_t slot = slot_of(h, displacements_[bucket_of(h)]);
+        return keys_[slot] == key ? indices_[slot] : npos;
+    }
+
+    constexpr bool contains(std::string_view key) const noexcept
+    {
+        return find(key) != npos;
+    }
+};
+
+template <std::size_t N>
+consteval auto make_perfect_hash(const std::array<std::string_view, N>& keys)
+{
+    return PerfectHash<N>{keys};
+}
+
+// make_perfect_hash<Str{"if"}, Str{"else"}>() - keys view the template parameter objects
+template <Str... Keys>
+consteval auto make_perfect_hash()
+{
+    return PerfectHash<sizeof...(Keys)>{std::array<std::string_view, sizeof...(Keys)>{Keys.view()...}};
+}
+
+#endif //CONSTEXPR_PERFECT_HASH_HPP
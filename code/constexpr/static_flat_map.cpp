@@ -0,0 +1,118 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "static_flat_map.hpp"
+#include <algorithm>
+#include <array>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std::literals;
+
+namespace
+{
+    constexpr std::array<std::pair<int, std::string_view>, 40> http_status_codes = {{
+        {404, "Not Found"}, {200, "OK"}, {500, "Internal Server Error"}, {100, "Continue"},
+        {101, "Switching Protocols"}, {201, "Created"}, {202, "Accepted"}, {203, "Non-Authoritative Information"},
+        {204, "No Content"}, {205, "Reset Content"}, {206, "Partial Content"}, {300, "Multiple Choices"},
+        {301, "Moved Permanently"}, {302, "Found"}, {303, "See Other"}, {304, "Not Modified"},
+        {307, "Temporary Redirect"}, {308, "Permanent Redirect"}, {400, "Bad Request"}, {401, "Unauthorized"},
+        {402, "Payment Required"}, {403, "Forbidden"}, {405, "Method Not Allowed"}, {406, "Not Acceptable"},
+        {407, "Proxy Authentication Required"}, {408, "Request Timeout"}, {409, "Conflict"}, {410, "Gone"},
+        {411, "Length Required"}, {412, "Precondition Failed"}, {413, "Content Too Large"}, {414, "URI Too Long"},
+        {415, "Unsupported Media Type"}, {416, "Range Not Satisfiable"}, {417, "Expectation Failed"},
+        {429, "Too Many Requests"}, {501, "Not Implemented"}, {502, "Bad Gateway"}, {503, "Service Unavailable"},
+        {504, "Gateway Timeout"}}};
+
+    constexpr static_flat_map status_texts{http_status_codes};
+}
+
+TEST_CASE("static_flat_map")
+{
+    SECTION("lookup at compile time")
+    {
+        static_assert(status_texts.size() == 40);
+        static_assert(*status_texts.find(404) == "Not Found"sv);
+        static_assert(status_texts.at(100) == "Continue"sv);
+        static_assert(status_texts.at(504) == "Gateway Timeout"sv);
+        static_assert(!status_texts.contains(99));
+        static_assert(!status_texts.contains(418));
+        static_assert(!status_texts.contains(600));
+    }
+
+    SECTION("every key is found, gaps between keys are not")
+    {
+        for (const auto& [code, text] : http_status_codes)
+        {
+            CAPTURE(code);
+            REQUIRE(status_texts.at(code) == text);
+            REQUIRE_FALSE(status_texts.contains(code + 1000));
+        }
+
+        for (int code = 0; code < 700; ++code)
+        {
+            const bool expected = std::ranges::find(http_status_codes, code, &std::pair<int, std::string_view>::first) != http_status_codes.end();
+            REQUIRE(status_texts.contains(code) == expected);
+        }
+
+        REQUIRE_THROWS_AS(status_texts.at(418), std::out_of_range);
+    }
+
+    SECTION("small maps")
+    {
+        constexpr static_flat_map one{std::array{std::pair{'x', 1}}};
+        static_assert(one.at('x') == 1 && !one.contains('a') && !one.contains('z'));
+
+        constexpr static_flat_map opcodes{std::array{std::pair{0x90, "nop"sv}, std::pair{0xC3, "ret"sv}, std::pair{0xCC, "int3"sv}}};
+        static_assert(opcodes.at(0xC3) == "ret"sv);
+    }
+
+    SECTION("duplicated keys")
+    {
+        REQUIRE_THROWS_AS((static_flat_map{std::array{std::pair{1, 1}, std::pair{1, 2}}}), std::invalid_argument);
+    }
+}
+
+TEST_CASE("static_flat_map - benchmarks", "[.][benchmark]")
+{
+    std::vector<int> codes(10'000);
+    std::mt19937 rnd{665};
+    std::uniform_int_distribution<int> distr{100, 510};
+    for (auto& code : codes)
+        code = distr(rnd);
+
+    const std::map<int, std::string_view> map(http_status_codes.begin(), http_status_codes.end());
+
+    auto sorted = http_status_codes;
+    std::ranges::sort(sorted);
+
+    BENCHMARK("10'000 lookups - static_flat_map")
+    {
+        std::size_t length = 0;
+        for (int code : codes)
+            if (const auto* text = status_texts.find(code))
+                length += text->size();
+        return length;
+    };
+
+    BENCHMARK("10'000 lookups - std::map")
+    {
+        std::size_t length = 0;
+        for (int code : codes)
+            if (auto it = map.find(code); it != map.end())
+                length += it->second.size();
+        return length;
+    };
+
+    BENCHMARK("10'000 lookups - std::lower_bound on sorted array")
+    {
+        std::size_t length = 0;
+        for (int code : codes)
+            if (auto it = std::ranges::lower_bound(sorted, code, {}, &std::pair<int, std::string_view>::first); it != sorted.end() && it->first == code)
+                length += it->second.size();
+        return length;
+    };
+}
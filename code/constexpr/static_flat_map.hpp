@@ -0,0 +1,79 @@
+#ifndef CONSTEXPR_STATIC_FLAT_MAP_HPP
+#define CONSTEXPR_STATIC_FLAT_MAP_HPP
+
+#include "eytzinger.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+//////////////////////////////////////////////////////////////////
+// static_flat_map<K, V, N> - immutable map sorted at compile time
+//   constexpr static_flat_map<int, std::string_view, 3> status{{{{404, "Not Found"}, {200, "OK"}, {500, "Server Error"}}}};
+//   * keys are stored in the Eytzinger (BFS) layout - the first levels of the search share
+//     cache lines & the lookup is a branch-free descent
+//   * duplicated keys fail the build (or throw std::invalid_argument at runtime)
+//   * K needs operator< - K & V need a default constructor (the arrays are value-initialized)
+template <typename K, typename V, std::size_t N>
+class static_flat_map
+{
+    std::array<K, N + 1> keys_{};   // 1-based Eytzinger layout, keys_[0] is unused
+    std::array<V, N + 1> values_{}; // values_[k] belongs to keys_[k]
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+
+    constexpr explicit static_flat_map(std::array<value_type, N> items)
+    {
+        std::sort(items.begin(), items.end(), [](const value_type& a, const value_type& b) { return a.first < b.first; });
+
+        for (std::size_t i = 1; i < N; ++i)
+            if (!(items[i - 1].first < items[i].first))
+                throw std::invalid_argument("duplicated key in static_flat_map");
+
+        std::array<std::size_t, N> order{};
+        for (std::size_t i = 0; i < N; ++i)
+            order[i] = i;
+
+        std::array<std::size_t, N + 1> layout{};
+        detail::eytzinger_fill(order, layout);
+
+        for (std::size_t k = 1; k <= N; ++k)
+        {
+            keys_[k] = items[layout[k]].first;
+            values_[k] = items[layout[k]].second;
+        }
+    }
+
+    static constexpr std::size_t size() noexcept
+    {
+        return N;
+    }
+
+    // nullptr if the key is missing
+    constexpr const V* find(const K& key) const noexcept
+    {
+        const std::size_t k = detail::eytzinger_search<false>(keys_.data(), N, [&key](const K& item) { return item < key; });
+        return k != 0 && !(key < keys_[k]) ? &values_[k] : nullptr;
+    }
+
+    constexpr bool contains(const K& key) const noexcept
+    {
+        return find(key) != nullptr;
+    }
+
+    constexpr const V& at(const K& key) const
+    {
+        if (const V* value = find(key))
+            return *value;
+        throw std::out_of_range("key not found in static_flat_map");
+    }
+};
+
+template <typename K, typename V, std::size_t N>
+static_flat_map(std::array<std::pair<K, V>, N>) -> static_flat_map<K, V, N>;
+
+#endif //CONSTEXPR_STATIC_FLAT_MAP_HPP
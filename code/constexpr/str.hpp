@@ -0,0 +1,36 @@
+#ifndef CONSTEXPR_STR_HPP
+#define CONSTEXPR_STR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+
+//////////////////////////////////////////////////////////////////
+// Str - string literal as a template parameter (structural type)
+//   Message<Str{"Hello"}> - N is deduced with CTAD & includes the terminating '\0'
+//   * the converting constructor lets a bare literal initialize the parameter: Message<"Hello">
+template <std::size_t N>
+struct Str
+{
+    char chars[N];
+
+    constexpr Str(const char (&text)[N]) noexcept
+    {
+        std::copy_n(text, N, chars);
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+        return N - 1;
+    }
+
+    constexpr std::string_view view() const noexcept
+    {
+        return {chars, N - 1};
+    }
+};
+
+template <std::size_t N>
+Str(const char (&)[N]) -> Str<N>;
+
+#endif //CONSTEXPR_STR_HPP
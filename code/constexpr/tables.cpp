@@ -0,0 +1,88 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "tables.hpp"
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+
+using namespace std::literals;
+
+TEST_CASE("make_table")
+{
+    SECTION("squares")
+    {
+        constexpr auto squares = tables::make_table<10>([](size_t i) { return static_cast<int>((i + 1) * (i + 1)); });
+
+        static_assert(squares.front() == 1 && squares.back() == 100);
+    }
+
+    SECTION("crc32")
+    {
+        static_assert(tables::crc32_table[1] == 0x77073096);
+        static_assert(tables::crc32("123456789"sv) == 0xCBF43926); // check value of CRC-32/ISO-HDLC
+        static_assert(tables::crc32(""sv) == 0);
+
+        REQUIRE(tables::crc32("The quick brown fox jumps over the lazy dog"sv) == 0x414FA339);
+    }
+
+    SECTION("popcount & bit reversal")
+    {
+        static_assert(tables::popcount(0xFFFFFFFF) == 32);
+        static_assert(tables::reverse_bits(0x00000001) == 0x80000000);
+        static_assert(tables::reverse_bits(0x12345678) == 0x1E6A2C48);
+
+        for (std::uint32_t value : {0u, 1u, 0x80000000u, 0xDEADBEEFu, 0x0F0F0F0Fu, 123456789u})
+        {
+            REQUIRE(tables::popcount(value) == std::popcount(value));
+            REQUIRE(tables::reverse_bits(tables::reverse_bits(value)) == value);
+        }
+    }
+
+    SECTION("fast_sin")
+    {
+        static_assert(tables::sin_samples[tables::sin_table_size / 4] > 0.999999f);
+
+        for (float x = -20.0f; x < 20.0f; x += 0.001f)
+            REQUIRE(std::abs(tables::fast_sin(x) - std::sin(x)) < 1e-5f);
+    }
+}
+
+TEST_CASE("make_table - benchmarks", "[.][benchmark]")
+{
+    std::string data(1'000'000, '\0');
+    std::mt19937 rnd{665};
+    for (auto& c : data)
+        c = static_cast<char>(rnd());
+
+    volatile std::uint32_t polynomial = tables::crc32_polynomial; // the runtime table can not be folded by the optimizer
+
+    BENCHMARK("building the CRC32 table at runtime")
+    {
+        return tables::make_table<256>([p = polynomial](std::size_t i) { return tables::crc32_entry(i, p); });
+    };
+
+    BENCHMARK("CRC32 of 1 MB - compile-time table")
+    {
+        return tables::crc32(data);
+    };
+
+    BENCHMARK("CRC32 of 1 MB - table built at runtime (construction included)")
+    {
+        const auto table = tables::make_table<256>([p = polynomial](std::size_t i) { return tables::crc32_entry(i, p); });
+        return tables::crc32(data, table);
+    };
+
+    BENCHMARK("CRC32 of 100 bytes - compile-time table")
+    {
+        return tables::crc32(std::string_view{data}.substr(0, 100));
+    };
+
+    BENCHMARK("CRC32 of 100 bytes - table built at runtime (construction included)")
+    {
+        const auto table = tables::make_table<256>([p = polynomial](std::size_t i) { return tables::crc32_entry(i, p); });
+        return tables::crc32(std::string_view{data}.substr(0, 100), table);
+    };
+}
@@ -0,0 +1,132 @@
+#ifndef CONSTEXPR_TABLES_HPP
+#define CONSTEXPR_TABLES_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numbers>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace tables
+{
+    //////////////////////////////////////////////////////////////////
+    // make_table<N>(f) - std::array of f(0), f(1), ..., f(N - 1)
+    //   * in a constexpr variable the table is built by the compiler & lands in .rodata
+    //   * the same call builds the table at runtime when f is not a constant
+    template <std::size_t N, typename F>
+        requires std::is_invocable_v<F&, std::size_t>
+    constexpr auto make_table(F f)
+    {
+        std::array<std::invoke_result_t<F&, std::size_t>, N> table{};
+
+        for (std::size_t i = 0; i < N; ++i)
+            table[i] = std::invoke(f, i);
+
+        return table;
+    }
+
+    constexpr std::uint32_t crc32_polynomial = 0xEDB88320; // reflected IEEE 802.3
+
+    constexpr std::uint32_t crc32_entry(std::size_t index, std::uint32_t polynomial = crc32_polynomial) noexcept
+    {
+        auto crc = static_cast<std::uint32_t>(index);
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc & 1) ? (crc >> 1) ^ polynomial : crc >> 1;
+        return crc;
+    }
+
+    constexpr std::uint8_t popcount_entry(std::size_t index) noexcept
+    {
+        std::uint8_t count = 0;
+        for (; index; index &= index - 1)
+            ++count;
+        return count;
+    }
+
+    constexpr std::uint8_t reverse_bits_entry(std::size_t index) noexcept
+    {
+        std::uint8_t reversed = 0;
+        for (int bit = 0; bit < 8; ++bit)
+            reversed |= ((index >> bit) & 1) << (7 - bit);
+        return reversed;
+    }
+
+    // Taylor series - std::sin is not constexpr in C++20
+    constexpr double sin(double x) noexcept
+    {
+        while (x > std::numbers::pi)
+            x -= 2 * std::numbers::pi;
+        while (x < -std::numbers::pi)
+            x += 2 * std::numbers::pi;
+
+        double term = x;
+        double sum = x;
+        for (int n = 1; n < 12; ++n)
+        {
+            term *= -x * x / ((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr std::size_t sin_table_size = 1024; // samples of a full turn
+
+    namespace detail
+    {
+        inline constexpr auto crc32 = make_table<256>([](std::size_t i) { return crc32_entry(i); });
+        inline constexpr auto popcount = make_table<256>(popcount_entry);
+        inline constexpr auto reverse_bits = make_table<256>(reverse_bits_entry);
+        inline constexpr auto sin = make_table<sin_table_size + 1>([](std::size_t i) {
+            return static_cast<float>(tables::sin(2 * std::numbers::pi * static_cast<double>(i) / sin_table_size));
+        });
+    }
+
+    inline constexpr std::span<const std::uint32_t, 256> crc32_table = detail::crc32;
+    inline constexpr std::span<const std::uint8_t, 256> popcount_table = detail::popcount;
+    inline constexpr std::span<const std::uint8_t, 256> reverse_bits_table = detail::reverse_bits;
+    inline constexpr std::span<const float, sin_table_size + 1> sin_samples = detail::sin;
+
+    // byte-at-a-time CRC32 (zlib, PNG) - the table may be replaced with one built at runtime
+    constexpr std::uint32_t crc32(std::string_view data, std::span<const std::uint32_t, 256> table = crc32_table) noexcept
+    {
+        std::uint32_t crc = 0xFFFFFFFF;
+        for (char c : data)
+            crc = table[(crc ^ static_cast<unsigned char>(c)) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFF;
+    }
+
+    constexpr int popcount(std::uint32_t value) noexcept
+    {
+        return popcount_table[value & 0xFF] + popcount_table[(value >> 8) & 0xFF]
+            + popcount_table[(value >> 16) & 0xFF] + popcount_table[value >> 24];
+    }
+
+    constexpr std::uint32_t reverse_bits(std::uint32_t value) noexcept
+    {
+        return (std::uint32_t{reverse_bits_table[value & 0xFF]} << 24) | (std::uint32_t{reverse_bits_table[(value >> 8) & 0xFF]} << 16)
+            | (std::uint32_t{reverse_bits_table[(value >> 16) & 0xFF]} << 8) | reverse_bits_table[value >> 24];
+    }
+
+    // sine by linear interpolation of the table - absolute error below 1e-5
+    inline float fast_sin(float x) noexcept
+    {
+        constexpr float samples_per_radian = sin_table_size / (2 * std::numbers::pi_v<float>);
+
+        float position = x * samples_per_radian;
+        position -= sin_table_size * static_cast<float>(static_cast<long long>(position / sin_table_size));
+        if (position < 0)
+            position += sin_table_size;
+
+        const auto index = std::min(static_cast<std::size_t>(position), sin_table_size - 1);
+        const float fraction = position - static_cast<float>(index);
+
+        return sin_samples[index] + fraction * (sin_samples[index + 1] - sin_samples[index]);
+    }
+}
+
+#endif //CONSTEXPR_TABLES_HPP
@@ -0,0 +1,128 @@
+#ifndef COROUTINES_ASYNC_FILE_READER_HPP
+#define COROUTINES_ASYNC_FILE_READER_HPP
+
+#include "blocking_thread_pool.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+
+namespace coro
+{
+    //////////////////////////////////////////////////////////////////
+    // file reader with awaitable reads executed on a BlockingThreadPool
+    //   * a read starts when read() is called - co_await only waits for the result,
+    //     so a producer can request the next chunk before processing the current one
+    //   * the awaiting coroutine is resumed on the I/O thread
+    //   * a read that was never awaited is waited for in the destructor of ReadOperation,
+    //     so a producer destroyed mid-stream never leaves a write into a freed buffer
+    class AsyncFileReader
+    {
+        struct ReadState
+        {
+            enum : int { pending, completed, awaited };
+
+            std::atomic<int> state{pending};
+            std::size_t bytes_read{};
+            std::exception_ptr exception;
+            std::coroutine_handle<> waiting;
+        };
+
+        BlockingThreadPool& pool_;
+        std::mutex file_mtx_;
+        std::ifstream file_;
+
+    public:
+        class ReadOperation
+        {
+            std::shared_ptr<ReadState> state_;
+
+        public:
+            explicit ReadOperation(std::shared_ptr<ReadState> state)
+                : state_{std::move(state)}
+            {
+            }
+
+            ReadOperation(ReadOperation&&) noexcept = default;
+
+            ReadOperation& operator=(ReadOperation&& other) noexcept
+            {
+                ReadOperation temp{std::move(other)};
+                std::swap(state_, temp.state_);
+                return *this;
+            }
+
+            ~ReadOperation()
+            {
+                if (state_)
+                    state_->state.wait(ReadState::pending, std::memory_order_acquire);
+            }
+
+            bool await_ready() const noexcept
+            {
+                return state_->state.load(std::memory_order_acquire) == ReadState::completed;
+            }
+
+            bool await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                state_->waiting = awaiting;
+
+                int expected = ReadState::pending;
+                return state_->state.compare_exchange_strong(expected, ReadState::awaited, std::memory_order_acq_rel);
+            }
+
+            // number of bytes read - less than the size of the buffer at the end of file
+            std::size_t await_resume() const
+            {
+                if (state_->exception)
+                    std::rethrow_exception(state_->exception);
+                return state_->bytes_read;
+            }
+        };
+
+        AsyncFileReader(BlockingThreadPool& pool, const std::filesystem::path& path)
+            : pool_{pool}
+            , file_{path, std::ios::binary}
+        {
+            if (!file_)
+                throw std::runtime_error{"Cannot open file: " + path.string()};
+        }
+
+        ReadOperation read(std::span<std::byte> buffer, std::uint64_t offset)
+        {
+            auto state = std::make_shared<ReadState>();
+
+            pool_.submit([this, state, buffer, offset] {
+                try
+                {
+                    std::lock_guard lock{file_mtx_};
+                    file_.clear();
+                    file_.seekg(static_cast<std::streamoff>(offset));
+                    file_.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+                    state->bytes_read = static_cast<std::size_t>(file_.gcount());
+                }
+                catch (...)
+                {
+                    state->exception = std::current_exception();
+                }
+
+                if (state->state.exchange(ReadState::completed, std::memory_order_acq_rel) == ReadState::awaited)
+                    state->waiting.resume();
+                else
+                    state->state.notify_all();
+            });
+
+            return ReadOperation{std::move(state)};
+        }
+    };
+}
+
+#endif //COROUTINES_ASYNC_FILE_READER_HPP
@@ -0,0 +1,231 @@
+#include "catch.hpp"
+#include "async_file_reader.hpp"
+#include "async_generator.hpp"
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace coro;
+
+namespace
+{
+    // suspends & resumes the awaiting coroutine at once
+    struct Answer
+    {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> coro) const noexcept
+        {
+            return coro;
+        }
+
+        int await_resume() const noexcept
+        {
+            return 42;
+        }
+    };
+
+    // coroutine started at the call - runs to completion on the thread that resumes it last
+    struct Detached
+    {
+        struct promise_type
+        {
+            Detached get_return_object() noexcept
+            {
+                return {};
+            }
+
+            std::suspend_never initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            std::suspend_never final_suspend() noexcept
+            {
+                return {};
+            }
+
+            void return_void() noexcept
+            {
+            }
+
+            void unhandled_exception() noexcept
+            {
+                std::terminate();
+            }
+        };
+    };
+
+    async_generator<int> numbers(int count)
+    {
+        for (int i = 0; i < count; ++i)
+            co_yield co_await Answer{} + i;
+    }
+
+    // ints stored in a binary file - next chunk is read while the current one is processed
+    async_generator<int> read_ints(AsyncFileReader& reader, size_t chunk_size)
+    {
+        std::vector<std::byte> current(chunk_size * sizeof(int));
+        std::vector<std::byte> next(chunk_size * sizeof(int));
+        std::uint64_t offset = 0;
+
+        auto pending_read = reader.read(current, offset);
+
+        while (true)
+        {
+            const size_t bytes_read = co_await pending_read;
+            offset += bytes_read;
+
+            if (bytes_read == 0)
+                co_return;
+
+            pending_read = reader.read(next, offset); // overlaps with processing of the current chunk
+
+            for (size_t pos = 0; pos + sizeof(int) <= bytes_read; pos += sizeof(int))
+            {
+                int value;
+                std::memcpy(&value, current.data() + pos, sizeof(int));
+                co_yield value;
+            }
+
+            std::swap(current, next);
+        }
+    }
+
+    async_generator<int> take_until(async_generator<int>& g, int sentinel)
+    {
+        for (auto it = co_await g.begin(); it != g.end(); co_await ++it)
+        {
+            if (*it == sentinel)
+                break;
+            co_yield *it;
+        }
+    }
+
+    async_generator<int> multiply(async_generator<int>& seq, int factor)
+    {
+        for (auto it = co_await seq.begin(); it != seq.end(); co_await ++it)
+            co_yield *it * factor;
+    }
+
+    async_generator<int> add(async_generator<int>& seq, int offset)
+    {
+        for (auto it = co_await seq.begin(); it != seq.end(); co_await ++it)
+            co_yield *it + offset;
+    }
+
+    // the generator is destroyed before the result is set
+    Detached collect(async_generator<int> g, std::promise<std::vector<int>>& result)
+    {
+        try
+        {
+            std::vector<int> values;
+            {
+                async_generator<int> source = std::move(g);
+                for (auto it = co_await source.begin(); it != source.end(); co_await ++it)
+                    values.push_back(*it);
+            }
+            result.set_value(std::move(values));
+        }
+        catch (...)
+        {
+            result.set_exception(std::current_exception());
+        }
+    }
+
+    std::vector<int> to_vector(async_generator<int> g)
+    {
+        std::promise<std::vector<int>> result;
+        auto values = result.get_future();
+        collect(std::move(g), result);
+        return values.get();
+    }
+
+    Detached sum_of_chain(AsyncFileReader& reader, std::promise<int>& result)
+    {
+        int sum = 0;
+        {
+            auto g = read_ints(reader, 4);
+            auto t = take_until(g, 10);
+            auto m = multiply(t, 10);
+            auto a = add(m, 15);
+
+            for (auto it = co_await a.begin(); it != a.end(); co_await ++it)
+                sum += *it;
+        }
+        result.set_value(sum);
+    }
+
+    struct TemporaryFile
+    {
+        std::filesystem::path path;
+
+        explicit TemporaryFile(const std::vector<int>& values)
+            : path{std::filesystem::temp_directory_path() / ("coro_ints_" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".bin")}
+        {
+            std::ofstream out{path, std::ios::binary};
+            out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(int)));
+        }
+
+        ~TemporaryFile()
+        {
+            std::filesystem::remove(path);
+        }
+    };
+}
+
+TEST_CASE("async generator")
+{
+    SECTION("co_await inside the producer")
+    {
+        REQUIRE(to_vector(numbers(3)) == std::vector{42, 43, 44});
+    }
+
+    SECTION("empty")
+    {
+        REQUIRE(to_vector(numbers(0)).empty());
+    }
+
+    SECTION("exceptions")
+    {
+        auto throwing = []() -> async_generator<int> {
+            co_yield 1;
+            throw std::runtime_error{"error"};
+        };
+
+        REQUIRE_THROWS_AS(to_vector(throwing()), std::runtime_error);
+    }
+}
+
+TEST_CASE("async chain of generators - reading a file")
+{
+    std::vector<int> values(10'000);
+    std::iota(values.begin(), values.end(), 0);
+    TemporaryFile file{values};
+
+    BlockingThreadPool io_pool{2};
+    AsyncFileReader reader{io_pool, file.path};
+
+    SECTION("all values")
+    {
+        REQUIRE(to_vector(read_ints(reader, 256)) == values);
+    }
+
+    SECTION("take_until | multiply | add")
+    {
+        std::promise<int> sum;
+        auto result = sum.get_future();
+        sum_of_chain(reader, sum);
+
+        REQUIRE(result.get() == 600);
+    }
+}
@@ -0,0 +1,229 @@
+#ifndef COROUTINES_ASYNC_GENERATOR_HPP
+#define COROUTINES_ASYNC_GENERATOR_HPP
+
+#include "frame_allocator.hpp"
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace coro
+{
+    //////////////////////////////////////////////////////////////////
+    // async_generator<T> - generator that may co_await inside its body
+    //   * producer: co_await any awaitable (I/O, thread hops), co_yield values
+    //   * consumer (a coroutine) iterates with co_await:
+    //       for (auto it = co_await gen.begin(); it != gen.end(); co_await ++it)
+    //           process(*it);
+    //   * control is passed between producer and consumer by symmetric transfer -
+    //     the consumer is resumed on the thread that produced the value
+    template <typename T>
+    class async_generator
+    {
+    public:
+        using value_type = std::remove_cvref_t<T>;
+        using reference = std::add_lvalue_reference_t<T>;
+
+        class promise_type;
+        class iterator;
+
+    private:
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        struct ResumeConsumer
+        {
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(handle_type producer) const noexcept
+            {
+                return producer.promise().consumer_;
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+    public:
+        class promise_type : public FrameAllocation
+        {
+            std::add_pointer_t<reference> value_ = nullptr;
+            std::exception_ptr exception_;
+            std::coroutine_handle<> consumer_;
+
+            friend async_generator;
+
+        public:
+            async_generator get_return_object() noexcept
+            {
+                return async_generator{handle_type::from_promise(*this)};
+            }
+
+            std::suspend_always initial_suspend() const noexcept
+            {
+                return {};
+            }
+
+            ResumeConsumer final_suspend() const noexcept
+            {
+                return {};
+            }
+
+            ResumeConsumer yield_value(std::remove_reference_t<T>& value) noexcept
+            {
+                value_ = std::addressof(value);
+                return {};
+            }
+
+            ResumeConsumer yield_value(std::remove_reference_t<T>&& value) noexcept
+            {
+                value_ = std::addressof(value);
+                return {};
+            }
+
+            void return_void() const noexcept
+            {
+            }
+
+            void unhandled_exception() noexcept
+            {
+                exception_ = std::current_exception();
+            }
+
+            reference current() const noexcept
+            {
+                return *value_;
+            }
+
+            void rethrow_if_exception()
+            {
+                if (exception_)
+                    std::rethrow_exception(std::exchange(exception_, nullptr));
+            }
+        };
+
+    private:
+        // resumes the producer until it yields the next value or completes
+        struct AdvanceAwaiter
+        {
+            handle_type producer;
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) noexcept
+            {
+                producer.promise().consumer_ = consumer;
+                return producer;
+            }
+        };
+
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = typename async_generator::value_type;
+            using reference = typename async_generator::reference;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            reference operator*() const noexcept
+            {
+                return coro_.promise().current();
+            }
+
+            // co_await ++it
+            auto operator++() noexcept
+            {
+                struct IncrementAwaiter : AdvanceAwaiter
+                {
+                    iterator& it;
+
+                    iterator& await_resume()
+                    {
+                        it.coro_.promise().rethrow_if_exception();
+                        return it;
+                    }
+                };
+
+                return IncrementAwaiter{{coro_}, *this};
+            }
+
+            friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept
+            {
+                auto at_end = [](const iterator& it) { return !it.coro_ || it.coro_.done(); };
+                return at_end(lhs) && at_end(rhs);
+            }
+
+        private:
+            handle_type coro_ = nullptr;
+
+            friend async_generator;
+
+            explicit iterator(handle_type coro) noexcept
+                : coro_{coro}
+            {
+            }
+        };
+
+        async_generator() = default;
+
+        async_generator(async_generator&& other) noexcept
+            : coro_{std::exchange(other.coro_, nullptr)}
+        {
+        }
+
+        async_generator& operator=(async_generator other) noexcept
+        {
+            std::swap(coro_, other.coro_);
+            return *this;
+        }
+
+        ~async_generator()
+        {
+            if (coro_)
+                coro_.destroy();
+        }
+
+        // co_await gen.begin()
+        auto begin() noexcept
+        {
+            struct BeginAwaiter : AdvanceAwaiter
+            {
+                iterator await_resume()
+                {
+                    this->producer.promise().rethrow_if_exception();
+                    return iterator{this->producer};
+                }
+            };
+
+            return BeginAwaiter{{coro_}};
+        }
+
+        iterator end() const noexcept
+        {
+            return {};
+        }
+
+    private:
+        handle_type coro_ = nullptr;
+
+        explicit async_generator(handle_type coro) noexcept
+            : coro_{coro}
+        {
+        }
+    };
+}
+
+#endif //COROUTINES_ASYNC_GENERATOR_HPP
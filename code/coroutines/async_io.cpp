@@ -0,0 +1,234 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+
+#if __has_include(<unistd.h>)
+
+#include "async_generator.hpp"
+#include "async_io.hpp"
+#include "static_thread_pool.hpp"
+#include "sync_wait.hpp"
+#include "task.hpp"
+#include "when_all.hpp"
+#include <algorithm>
+#include <fcntl.h>
+#include <filesystem>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace coro;
+
+namespace
+{
+    class TemporaryFile
+    {
+        std::filesystem::path path_;
+        int fd_;
+
+    public:
+        explicit TemporaryFile(const std::string& name)
+            : path_{std::filesystem::temp_directory_path() / (name + "_" + std::to_string(::getpid()) + ".bin")}
+            , fd_{::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600)}
+        {
+            if (fd_ < 0)
+                throw std::system_error{errno, std::system_category(), "open"};
+        }
+
+        TemporaryFile(const TemporaryFile&) = delete;
+        TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+        ~TemporaryFile()
+        {
+            ::close(fd_);
+            std::filesystem::remove(path_);
+        }
+
+        int fd() const noexcept
+        {
+            return fd_;
+        }
+    };
+
+    std::vector<std::byte> make_content(std::size_t size)
+    {
+        std::vector<std::byte> content(size);
+        for (std::size_t i = 0; i < size; ++i)
+            content[i] = static_cast<std::byte>(i * 31 % 251);
+        return content;
+    }
+
+    task<> write_all(IoService& io, int fd, std::span<const std::byte> data)
+    {
+        std::uint64_t offset = 0;
+        while (offset < data.size())
+            offset += co_await io.async_write(fd, data.subspan(offset), offset);
+    }
+
+    eager_task<std::size_t> start_read(IoService& io, int fd, std::span<std::byte> buffer, std::uint64_t offset)
+    {
+        co_return co_await io.async_read(fd, buffer, offset);
+    }
+
+    // the next chunk is read while the current one is processed by the consumer
+    //   * the generator must be consumed to the end - the prefetch must not outlive the frame
+    async_generator<std::span<const std::byte>> read_chunks(IoService& io, int fd, std::size_t chunk_size)
+    {
+        std::vector<std::byte> current(chunk_size);
+        std::vector<std::byte> next(chunk_size);
+        std::uint64_t offset = 0;
+
+        std::size_t bytes_read = co_await io.async_read(fd, current, offset);
+
+        while (bytes_read > 0)
+        {
+            offset += bytes_read;
+
+            auto prefetch = start_read(io, fd, next, offset);
+            co_yield std::span<const std::byte>{current.data(), bytes_read};
+
+            bytes_read = co_await prefetch;
+            std::swap(current, next);
+        }
+    }
+
+    task<std::uint64_t> checksum(IoService& io, int fd, std::size_t chunk_size)
+    {
+        std::uint64_t sum = 0;
+        auto chunks = read_chunks(io, fd, chunk_size);
+        for (auto it = co_await chunks.begin(); it != chunks.end(); co_await ++it)
+            for (std::byte b : *it)
+                sum += std::to_integer<unsigned>(b);
+        co_return sum;
+    }
+
+    // readers_count readers, each reading every readers_count-th block of the file
+    task<std::size_t> read_file(IoService& io, int fd, std::size_t file_size, std::size_t block_size, unsigned readers_count)
+    {
+        auto reader = [&](unsigned first_block) -> task<std::size_t> {
+            std::vector<std::byte> buffer(block_size);
+            std::size_t total = 0;
+            for (std::uint64_t offset = first_block * block_size; offset < file_size; offset += readers_count * block_size)
+                total += co_await io.async_read(fd, buffer, offset);
+            co_return total;
+        };
+
+        std::vector<task<std::size_t>> readers;
+        for (unsigned i = 0; i < readers_count; ++i)
+            readers.push_back(reader(i));
+
+        auto totals = co_await when_all(std::move(readers));
+        co_return std::accumulate(totals.begin(), totals.end(), std::size_t{0});
+    }
+
+    std::vector<IoBackend> available_backends()
+    {
+        std::vector<IoBackend> backends{IoBackend::thread_pool};
+        if (IoService{1}.backend() == IoBackend::io_uring)
+            backends.push_back(IoBackend::io_uring);
+        return backends;
+    }
+}
+
+TEST_CASE("IoService")
+{
+    const IoBackend backend = GENERATE(from_range(available_backends()));
+    CAPTURE(static_cast<int>(backend));
+
+    IoService io{8, backend};
+    REQUIRE(io.backend() == backend);
+
+    TemporaryFile file{"coro_async_io"};
+    const auto content = make_content(100'000);
+
+    sync_wait(write_all(io, file.fd(), content));
+
+    SECTION("read back")
+    {
+        std::vector<std::byte> buffer(content.size());
+        REQUIRE(sync_wait(io.async_read(file.fd(), buffer, 0)) == content.size());
+        REQUIRE(buffer == content);
+    }
+
+    SECTION("read at end of file")
+    {
+        std::vector<std::byte> buffer(16);
+        REQUIRE(sync_wait(io.async_read(file.fd(), buffer, content.size() - 10)) == 10);
+        REQUIRE(sync_wait(io.async_read(file.fd(), buffer, content.size())) == 0);
+    }
+
+    SECTION("streaming through an async generator")
+    {
+        const auto expected = std::accumulate(content.begin(), content.end(), std::uint64_t{0},
+            [](std::uint64_t sum, std::byte b) { return sum + std::to_integer<unsigned>(b); });
+
+        REQUIRE(sync_wait(checksum(io, file.fd(), 4096)) == expected);
+    }
+
+    SECTION("concurrent reads from a thread pool")
+    {
+        static_thread_pool pool{4};
+
+        auto read_on_pool = [&]() -> task<std::size_t> {
+            co_await pool.schedule();
+            co_return co_await read_file(io, file.fd(), content.size(), 4096, 8);
+        };
+
+        REQUIRE(sync_wait(read_on_pool()) == content.size());
+    }
+
+    SECTION("more concurrent requests than queue_depth - requests wait for a free slot")
+    {
+        IoService shallow_io{1, backend};
+        std::vector<std::byte> buffer(3 * 1024);
+
+        // resumed on the reaper/pool thread by the completion of the first read - the third read has to wait
+        auto two_reads_after_completion = [&]() -> task<std::size_t> {
+            std::size_t total = co_await shallow_io.async_read(file.fd(), std::span{buffer}.first(1024), 0);
+
+            auto second = start_read(shallow_io, file.fd(), std::span{buffer}.subspan(1024, 1024), 1024);
+            auto third = start_read(shallow_io, file.fd(), std::span{buffer}.subspan(2048), 2048);
+            total += co_await second;
+            total += co_await third;
+            co_return total;
+        };
+
+        REQUIRE(sync_wait(two_reads_after_completion()) == 3 * 1024);
+        REQUIRE(std::equal(buffer.begin(), buffer.end(), content.begin()));
+        REQUIRE(sync_wait(read_file(shallow_io, file.fd(), content.size(), 1024, 16)) == content.size());
+    }
+
+    SECTION("errors")
+    {
+        std::vector<std::byte> buffer(16);
+        REQUIRE_THROWS_AS(sync_wait(io.async_read(-1, buffer, 0)), std::system_error);
+    }
+}
+
+TEST_CASE("IoService - benchmarks", "[.][benchmark]")
+{
+    constexpr std::size_t file_size = 64 * 1024 * 1024;
+    constexpr std::size_t block_size = 128 * 1024;
+
+    TemporaryFile file{"coro_async_io_bench"};
+    {
+        IoService io{1, IoBackend::thread_pool};
+        sync_wait(write_all(io, file.fd(), make_content(file_size)));
+    }
+
+    for (IoBackend backend : available_backends())
+    {
+        for (unsigned queue_depth : {1u, 4u, 16u, 64u})
+        {
+            IoService io{queue_depth, backend};
+            const std::string name = std::string{backend == IoBackend::io_uring ? "io_uring" : "thread_pool"}
+                + " - 64 MiB in 128 KiB blocks - queue depth " + std::to_string(queue_depth);
+
+            BENCHMARK(name.c_str())
+            {
+                return sync_wait(read_file(io, file.fd(), file_size, block_size, queue_depth));
+            };
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,479 @@
+#ifndef COROUTINES_ASYNC_IO_HPP
+#define COROUTINES_ASYNC_IO_HPP
+
+// POSIX only - file descriptors, pread/pwrite
+
+#include "blocking_thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <cerrno>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define COROUTINES_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#else
+#define COROUTINES_HAS_IO_URING 0
+#endif
+
+namespace coro
+{
+#if COROUTINES_HAS_IO_URING
+    namespace detail
+    {
+        //////////////////////////////////////////////////////////////////
+        // minimal io_uring wrapper on raw system calls (no liburing)
+        //   * one thread submits at a time (the caller synchronizes), one thread reaps
+        class IoUring
+        {
+            int fd_ = -1;
+            io_uring_params params_{};
+
+            void* sq_ring_ = MAP_FAILED;
+            std::size_t sq_ring_size_ = 0;
+            void* cq_ring_ = MAP_FAILED;
+            std::size_t cq_ring_size_ = 0;
+            io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+            std::size_t sqes_size_ = 0;
+
+            unsigned* sq_head_;
+            unsigned* sq_tail_;
+            unsigned sq_mask_;
+            unsigned* sq_array_;
+            unsigned* cq_head_;
+            unsigned* cq_tail_;
+            unsigned cq_mask_;
+            io_uring_cqe* cqes_;
+
+            template <typename T>
+            static T* at(void* ring, unsigned offset) noexcept
+            {
+                return reinterpret_cast<T*>(static_cast<std::byte*>(ring) + offset);
+            }
+
+            static unsigned load_acquire(unsigned* value) noexcept
+            {
+                return std::atomic_ref<unsigned>{*value}.load(std::memory_order_acquire);
+            }
+
+            static void store_release(unsigned* value, unsigned new_value) noexcept
+            {
+                std::atomic_ref<unsigned>{*value}.store(new_value, std::memory_order_release);
+            }
+
+            void unmap() noexcept
+            {
+                if (sqes_ != MAP_FAILED)
+                    ::munmap(sqes_, sqes_size_);
+                if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_)
+                    ::munmap(cq_ring_, cq_ring_size_);
+                if (sq_ring_ != MAP_FAILED)
+                    ::munmap(sq_ring_, sq_ring_size_);
+                if (fd_ >= 0)
+                    ::close(fd_);
+            }
+
+        public:
+            explicit IoUring(unsigned entries)
+            {
+                fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params_));
+                if (fd_ < 0)
+                    throw std::system_error{errno, std::system_category(), "io_uring_setup"};
+
+                sq_ring_size_ = params_.sq_off.array + params_.sq_entries * sizeof(unsigned);
+                cq_ring_size_ = params_.cq_off.cqes + params_.cq_entries * sizeof(io_uring_cqe);
+
+                const bool single_mmap = params_.features & IORING_FEAT_SINGLE_MMAP;
+                if (single_mmap)
+                    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+                sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+                if (sq_ring_ == MAP_FAILED)
+                {
+                    const int error = errno;
+                    unmap();
+                    throw std::system_error{error, std::system_category(), "mmap(IORING_OFF_SQ_RING)"};
+                }
+
+                cq_ring_ = single_mmap
+                    ? sq_ring_
+                    : ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+
+                sqes_size_ = params_.sq_entries * sizeof(io_uring_sqe);
+                if (cq_ring_ != MAP_FAILED)
+                    sqes_ = static_cast<io_uring_sqe*>(
+                        ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES));
+
+                if (cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED)
+                {
+                    const int error = errno;
+                    unmap();
+                    throw std::system_error{error, std::system_category(), "mmap(io_uring)"};
+                }
+
+                sq_head_ = at<unsigned>(sq_ring_, params_.sq_off.head);
+                sq_tail_ = at<unsigned>(sq_ring_, params_.sq_off.tail);
+                sq_mask_ = *at<unsigned>(sq_ring_, params_.sq_off.ring_mask);
+                sq_array_ = at<unsigned>(sq_ring_, params_.sq_off.array);
+                cq_head_ = at<unsigned>(cq_ring_, params_.cq_off.head);
+                cq_tail_ = at<unsigned>(cq_ring_, params_.cq_off.tail);
+                cq_mask_ = *at<unsigned>(cq_ring_, params_.cq_off.ring_mask);
+                cqes_ = at<io_uring_cqe>(cq_ring_, params_.cq_off.cqes);
+            }
+
+            IoUring(const IoUring&) = delete;
+            IoUring& operator=(const IoUring&) = delete;
+
+            ~IoUring()
+            {
+                unmap();
+            }
+
+            static bool is_supported() noexcept
+            {
+                io_uring_params params{};
+                const int fd = static_cast<int>(::syscall(__NR_io_uring_setup, 1, &params));
+                if (fd < 0)
+                    return false;
+                ::close(fd);
+                return true;
+            }
+
+            unsigned sq_entries() const noexcept
+            {
+                return params_.sq_entries;
+            }
+
+            // writes one sqe and submits it - the caller guarantees a free entry & serializes submits
+            //   * if io_uring_enter fails the sqe is withdrawn & std::system_error is thrown -
+            //     no completion is ever posted for it
+            template <typename TPrepare>
+            void submit(TPrepare prepare)
+            {
+                const unsigned tail = *sq_tail_;
+                const unsigned index = tail & sq_mask_;
+
+                io_uring_sqe& sqe = sqes_[index];
+                std::memset(&sqe, 0, sizeof(sqe));
+                prepare(sqe);
+
+                sq_array_[index] = index;
+                store_release(sq_tail_, tail + 1);
+
+                while (::syscall(__NR_io_uring_enter, fd_, 1, 0, 0, nullptr, 0) < 0)
+                {
+                    if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                        continue;
+
+                    const int error = errno;
+                    if (load_acquire(sq_head_) != tail)
+                        return; // the kernel has consumed the sqe - it completes through the completion queue
+
+                    store_release(sq_tail_, tail);
+                    throw std::system_error{error, std::system_category(), "io_uring_enter"};
+                }
+            }
+
+            // blocks until at least one completion is available
+            void wait_for_completion()
+            {
+                if (load_acquire(cq_tail_) != *cq_head_)
+                    return;
+
+                while (::syscall(__NR_io_uring_enter, fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0)
+                {
+                    if (errno != EINTR)
+                        throw std::system_error{errno, std::system_category(), "io_uring_enter"};
+                }
+            }
+
+            struct Completion
+            {
+                std::uint64_t user_data;
+                std::int32_t result;
+            };
+
+            // the completion is consumed before it is handled, so the handler may submit new requests
+            std::optional<Completion> pop_completion() noexcept
+            {
+                const unsigned head = *cq_head_;
+                if (head == load_acquire(cq_tail_))
+                    return std::nullopt;
+
+                const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+                Completion completion{cqe.user_data, cqe.res};
+                store_release(cq_head_, head + 1);
+                return completion;
+            }
+        };
+    }
+#endif
+
+    enum class IoBackend
+    {
+        automatic, // io_uring if the kernel supports it, otherwise thread_pool
+        io_uring,
+        thread_pool
+    };
+
+    //////////////////////////////////////////////////////////////////
+    // IoService - awaitable positional reads & writes on file descriptors
+    //   * io_uring backend: requests are submitted from the awaiting thread,
+    //     a single reaper thread resumes the awaiting coroutines - CPU-heavy work after
+    //     co_await should move to a worker (co_await pool.schedule()) so that completions are not delayed
+    //   * thread_pool backend: pread/pwrite on a BlockingThreadPool (kernels without io_uring, non-Linux)
+    //   * at most queue_depth requests are in flight - a further request waits in a FIFO list and is
+    //     submitted by the thread completing an earlier one (a submit never blocks, so a coroutine resumed by
+    //     a completion may issue its next request on the reaper or a pool thread)
+    //   * like pread/pwrite a request may transfer fewer bytes than requested,
+    //     errors are reported with std::system_error
+    //   * all requests must complete before the service is destroyed
+    class IoService
+    {
+    public:
+        class Operation
+        {
+        public:
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> awaiting)
+            {
+                awaiting_ = awaiting;
+                service_.submit(*this);
+            }
+
+            std::size_t await_resume() const
+            {
+                if (result_ < 0)
+                    throw std::system_error{static_cast<int>(-result_), std::system_category(), is_write_ ? "async_write" : "async_read"};
+                return static_cast<std::size_t>(result_);
+            }
+
+        private:
+            friend IoService;
+
+            IoService& service_;
+            bool is_write_;
+            int fd_;
+            std::byte* buffer_;
+            unsigned size_;
+            std::uint64_t offset_;
+            std::int64_t result_ = 0;
+            std::coroutine_handle<> awaiting_;
+            Operation* next_ = nullptr; // intrusive list of requests waiting for a free slot
+
+            Operation(IoService& service, bool is_write, int fd, std::byte* buffer, std::size_t size, std::uint64_t offset) noexcept
+                : service_{service}
+                , is_write_{is_write}
+                , fd_{fd}
+                , buffer_{buffer}
+                , size_{static_cast<unsigned>(std::min<std::size_t>(size, max_request_size))}
+                , offset_{offset}
+            {
+            }
+
+            void complete(std::int64_t result)
+            {
+                result_ = result;
+                awaiting_.resume();
+            }
+        };
+
+        explicit IoService(unsigned queue_depth = 64, IoBackend backend = IoBackend::automatic)
+            : queue_depth_{std::max(queue_depth, 1u)}
+        {
+#if COROUTINES_HAS_IO_URING
+            if (backend == IoBackend::automatic)
+                backend = detail::IoUring::is_supported() ? IoBackend::io_uring : IoBackend::thread_pool;
+
+            if (backend == IoBackend::io_uring)
+            {
+                ring_.emplace(queue_depth + 1); // + wake-up request of the destructor
+                reaper_ = std::jthread{[this] { reap(); }};
+                backend_ = IoBackend::io_uring;
+                return;
+            }
+#else
+            if (backend == IoBackend::io_uring)
+                throw std::system_error{std::make_error_code(std::errc::function_not_supported), "io_uring"};
+#endif
+            pool_ = std::make_unique<BlockingThreadPool>(std::clamp(queue_depth, 1u, 64u));
+            backend_ = IoBackend::thread_pool;
+        }
+
+        IoService(const IoService&) = delete;
+        IoService& operator=(const IoService&) = delete;
+
+        ~IoService()
+        {
+#if COROUTINES_HAS_IO_URING
+            if (ring_)
+            {
+                {
+                    std::lock_guard lock{mtx_};
+                    ring_->submit([](io_uring_sqe& sqe) {
+                        sqe.opcode = IORING_OP_NOP;
+                        sqe.user_data = 0;
+                    });
+                }
+                reaper_.join();
+            }
+#endif
+        }
+
+        IoBackend backend() const noexcept
+        {
+            return backend_;
+        }
+
+        [[nodiscard]] Operation async_read(int fd, std::span<std::byte> buffer, std::uint64_t offset) noexcept
+        {
+            return Operation{*this, false, fd, buffer.data(), buffer.size(), offset};
+        }
+
+        [[nodiscard]] Operation async_write(int fd, std::span<const std::byte> buffer, std::uint64_t offset) noexcept
+        {
+            return Operation{*this, true, fd, const_cast<std::byte*>(buffer.data()), buffer.size(), offset};
+        }
+
+    private:
+        static constexpr std::size_t max_request_size = 1u << 30;
+
+        IoBackend backend_;
+        unsigned queue_depth_;
+
+        std::mutex mtx_; // guards in_flight_, the pending list & submits to the ring
+        unsigned in_flight_ = 0;
+        Operation* pending_head_ = nullptr;
+        Operation* pending_tail_ = nullptr;
+
+        std::unique_ptr<BlockingThreadPool> pool_;
+#if COROUTINES_HAS_IO_URING
+        std::optional<detail::IoUring> ring_;
+        std::jthread reaper_;
+
+        void reap()
+        {
+            while (true)
+            {
+                ring_->wait_for_completion();
+
+                while (auto completion = ring_->pop_completion())
+                {
+                    if (completion->user_data == 0)
+                        return;
+
+                    on_completion(*reinterpret_cast<Operation*>(completion->user_data), completion->result);
+                }
+            }
+        }
+#endif
+
+        // called from await_suspend() - queues the request if queue_depth requests are in flight
+        //   * throws if the request cannot be issued - the exception resumes the awaiting coroutine
+        void submit(Operation& op)
+        {
+            std::lock_guard lock{mtx_};
+
+            if (in_flight_ == queue_depth_)
+            {
+                op.next_ = nullptr;
+                (pending_tail_ ? pending_tail_->next_ : pending_head_) = &op;
+                pending_tail_ = &op;
+                return;
+            }
+
+            issue(op);
+            ++in_flight_; // op may already be completed on the reaper thread - it is resumed only after the lock is released
+        }
+
+        // the slot of a completed request passes to the first pending one
+        //   * a pending request that cannot be issued completes with -errno & frees its slot for the next one
+        void on_completion(Operation& op, std::int64_t result)
+        {
+            Operation* failed = nullptr;
+
+            {
+                std::lock_guard lock{mtx_};
+                --in_flight_;
+
+                while (pending_head_ && in_flight_ < queue_depth_)
+                {
+                    Operation* next = pending_head_;
+                    pending_head_ = next->next_;
+                    if (!pending_head_)
+                        pending_tail_ = nullptr;
+
+                    try
+                    {
+                        issue(*next);
+                        ++in_flight_;
+                    }
+                    catch (const std::system_error& e)
+                    {
+                        next->result_ = -e.code().value();
+                        next->next_ = failed;
+                        failed = next;
+                    }
+                    catch (const std::bad_alloc&)
+                    {
+                        next->result_ = -ENOMEM;
+                        next->next_ = failed;
+                        failed = next;
+                    }
+                }
+            }
+
+            op.complete(result);
+
+            while (failed)
+                std::exchange(failed, failed->next_)->complete(failed->result_);
+        }
+
+        // called with mtx_ held
+        void issue(Operation& op)
+        {
+#if COROUTINES_HAS_IO_URING
+            if (ring_)
+            {
+                ring_->submit([&op](io_uring_sqe& sqe) {
+                    sqe.opcode = op.is_write_ ? IORING_OP_WRITE : IORING_OP_READ;
+                    sqe.fd = op.fd_;
+                    sqe.addr = reinterpret_cast<std::uint64_t>(op.buffer_);
+                    sqe.len = op.size_;
+                    sqe.off = op.offset_;
+                    sqe.user_data = reinterpret_cast<std::uint64_t>(&op);
+                });
+                return;
+            }
+#endif
+
+            pool_->submit([this, &op] {
+                const ssize_t transferred = op.is_write_ ? ::pwrite(op.fd_, op.buffer_, op.size_, static_cast<off_t>(op.offset_))
+                                                         : ::pread(op.fd_, op.buffer_, op.size_, static_cast<off_t>(op.offset_));
+                on_completion(op, transferred < 0 ? -errno : transferred);
+            });
+        }
+    };
+}
+
+#endif //COROUTINES_ASYNC_IO_HPP
@@ -0,0 +1,33 @@
+#ifndef COROUTINES_AWAITABLE_TRAITS_HPP
+#define COROUTINES_AWAITABLE_TRAITS_HPP
+
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace coro
+{
+    namespace detail
+    {
+        template <typename TAwaitable>
+        decltype(auto) get_awaiter(TAwaitable&& awaitable)
+        {
+            if constexpr (requires { std::forward<TAwaitable>(awaitable).operator co_await(); })
+                return std::forward<TAwaitable>(awaitable).operator co_await();
+            else if constexpr (requires { operator co_await(std::forward<TAwaitable>(awaitable)); })
+                return operator co_await(std::forward<TAwaitable>(awaitable));
+            else
+                return std::forward<TAwaitable>(awaitable);
+        }
+    }
+
+    template <typename TAwaitable>
+    using await_result_t = decltype(detail::get_awaiter(std::declval<TAwaitable>()).await_resume());
+
+    // result of co_await that can be stored in a tuple/vector - void is replaced with std::monostate
+    template <typename TAwaitable>
+    using stored_await_result_t = std::conditional_t<std::is_void_v<await_result_t<TAwaitable>>,
+        std::monostate, std::remove_cvref_t<await_result_t<TAwaitable>>>;
+}
+
+#endif //COROUTINES_AWAITABLE_TRAITS_HPP
@@ -0,0 +1,178 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "batch_generator.hpp"
+#include "generator.hpp"
+#include "pipeline_stages.hpp"
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace coro;
+
+static_assert(std::ranges::input_range<batch_generator<int>>);
+static_assert(std::same_as<std::ranges::range_reference_t<batch_generator<int>>, std::span<const int>>);
+static_assert(batch_generator<int>::batch_size == 1024);
+
+namespace
+{
+    template <size_t BatchBytes>
+    batch_generator<int, BatchBytes> iota(int first, int last)
+    {
+        for (int i = first; i < last; ++i)
+            co_yield i;
+    }
+
+    namespace batched
+    {
+        batch_generator<int> gen()
+        {
+            for (int i = 0;; i++)
+                co_yield i;
+        }
+
+        batch_generator<int> take_until(batch_generator<int>& g, int sentinel)
+        {
+            for (auto batch : g)
+            {
+                for (int value : batch)
+                {
+                    if (value == sentinel)
+                        co_return;
+                    co_yield value;
+                }
+            }
+        }
+
+        batch_generator<int> multiply(batch_generator<int>& seq, int factor)
+        {
+            for (auto batch : seq)
+                for (int value : batch)
+                    co_yield value * factor;
+        }
+
+        batch_generator<int> add(batch_generator<int>& seq, int offset)
+        {
+            for (auto batch : seq)
+                for (int value : batch)
+                    co_yield value + offset;
+        }
+    }
+}
+
+TEST_CASE("batch generator")
+{
+    SECTION("values are delivered in batches")
+    {
+        std::vector<size_t> batch_sizes;
+        for (std::span<const int> batch : iota<4 * sizeof(int)>(0, 10))
+            batch_sizes.push_back(batch.size());
+
+        REQUIRE(batch_sizes == std::vector<size_t>{4, 4, 2});
+    }
+
+    SECTION("flush_batch")
+    {
+        auto flushing = []() -> batch_generator<int> {
+            co_yield 1;
+            co_yield flush_batch;
+            co_yield flush_batch; // empty buffer - no batch
+            co_yield 2;
+            co_yield 3;
+        };
+
+        std::vector<size_t> batch_sizes;
+        for (auto batch : flushing())
+            batch_sizes.push_back(batch.size());
+
+        REQUIRE(batch_sizes == std::vector<size_t>{1, 2});
+    }
+
+    SECTION("empty")
+    {
+        auto g = iota<64>(0, 0);
+        REQUIRE(g.begin() == g.end());
+    }
+
+    SECTION("exceptions")
+    {
+        auto throwing = []() -> batch_generator<int, 8> {
+            co_yield 1;
+            co_yield 2;
+            co_yield 3;
+            throw std::runtime_error{"error"};
+        };
+
+        auto g = throwing();
+        auto it = g.begin();
+        REQUIRE((*it).size() == 2);
+        REQUIRE_THROWS_AS(++it, std::runtime_error);
+    }
+}
+
+static_assert(std::invocable<const UnbatchFn&, batch_generator<int>&>);
+static_assert(!std::invocable<const UnbatchFn&, batch_generator<int>>); // the view would dangle
+static_assert(!std::invocable<const UnbatchFn&, std::vector<int>&>);    // not a range of batches
+
+TEST_CASE("unbatch")
+{
+    auto g = iota<3 * sizeof(int)>(0, 10);
+
+    REQUIRE(std::ranges::equal(g | unbatch, std::views::iota(0, 10)));
+
+    SECTION("vector of vectors")
+    {
+        std::vector<std::vector<int>> batches{{1, 2}, {}, {3}, {}};
+
+        REQUIRE(std::ranges::equal(batches | unbatch, std::vector{1, 2, 3}));
+    }
+
+    SECTION("chain of batch generators")
+    {
+        auto g = batched::gen();
+        auto t = batched::take_until(g, 10);
+        auto m = batched::multiply(t, 10);
+        auto a = batched::add(m, 15);
+
+        int sum = 0;
+        for (int value : a | unbatch)
+            sum += value;
+
+        REQUIRE(sum == 600);
+    }
+}
+
+TEST_CASE("batch generator - benchmarks", "[.][benchmark]")
+{
+    const int count = 100'000;
+
+    BENCHMARK("gen | take_until | multiply | add - generator<int>")
+    {
+        return pipeline_stages::sum_of_chain(count);
+    };
+
+    BENCHMARK("gen | take_until | multiply | add - batch_generator<int> + unbatch")
+    {
+        auto g = batched::gen();
+        auto t = batched::take_until(g, count);
+        auto m = batched::multiply(t, 10);
+        auto a = batched::add(m, 15);
+
+        long long sum{};
+        for (int value : a | unbatch)
+            sum += value;
+        return sum;
+    };
+
+    BENCHMARK("gen | take_until | multiply | add - batch_generator<int> + sum of spans")
+    {
+        auto g = batched::gen();
+        auto t = batched::take_until(g, count);
+        auto m = batched::multiply(t, 10);
+        auto a = batched::add(m, 15);
+
+        long long sum{};
+        for (auto batch : a)
+            sum = std::accumulate(batch.begin(), batch.end(), sum);
+        return sum;
+    };
+}
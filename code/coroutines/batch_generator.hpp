@@ -0,0 +1,340 @@
+#ifndef COROUTINES_BATCH_GENERATOR_HPP
+#define COROUTINES_BATCH_GENERATOR_HPP
+
+#include "frame_allocator.hpp"
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace coro
+{
+    //////////////////////////////////////////////////////////////////
+    // batch_generator<T> - generator that yields std::span<const T> chunks
+    //   * the body co_yields single values - they are appended to an internal buffer
+    //   * the coroutine is suspended only when the buffer is full (BatchBytes)
+    //     or when the body completes - one resume per batch instead of one per element
+    //   * 'co_yield flush_batch' hands over a partially filled buffer
+    struct FlushBatch
+    {
+    };
+
+    inline constexpr FlushBatch flush_batch{};
+
+    template <typename T, std::size_t BatchBytes = 4096>
+    class batch_generator : public std::ranges::view_interface<batch_generator<T, BatchBytes>>
+    {
+    public:
+        static constexpr std::size_t batch_size = std::max<std::size_t>(1, BatchBytes / sizeof(T));
+
+        class promise_type;
+        class iterator;
+
+    private:
+        using handle_type = std::coroutine_handle<promise_type>;
+
+    public:
+        class promise_type : public FrameAllocation
+        {
+            std::vector<T> buffer_;
+            std::exception_ptr exception_;
+
+            friend batch_generator;
+
+            struct BatchAwaiter
+            {
+                bool full;
+
+                bool await_ready() const noexcept
+                {
+                    return !full;
+                }
+
+                void await_suspend(std::coroutine_handle<>) const noexcept
+                {
+                }
+
+                void await_resume() const noexcept
+                {
+                }
+            };
+
+        public:
+            promise_type()
+            {
+                buffer_.reserve(batch_size);
+            }
+
+            batch_generator get_return_object() noexcept
+            {
+                return batch_generator{handle_type::from_promise(*this)};
+            }
+
+            std::suspend_always initial_suspend() const noexcept
+            {
+                return {};
+            }
+
+            std::suspend_always final_suspend() const noexcept
+            {
+                return {};
+            }
+
+            template <typename U = T>
+                requires std::constructible_from<T, U&&>
+            BatchAwaiter yield_value(U&& value)
+            {
+                buffer_.emplace_back(std::forward<U>(value));
+                return BatchAwaiter{buffer_.size() == batch_size};
+            }
+
+            BatchAwaiter yield_value(FlushBatch) noexcept
+            {
+                return BatchAwaiter{!buffer_.empty()};
+            }
+
+            template <typename TAwaitable>
+            TAwaitable&& await_transform(TAwaitable&&) = delete;
+
+            void return_void() const noexcept
+            {
+            }
+
+            void unhandled_exception()
+            {
+                exception_ = std::current_exception();
+            }
+
+            std::span<const T> batch() const noexcept
+            {
+                return buffer_;
+            }
+
+            void advance()
+            {
+                buffer_.clear();
+
+                const auto coro = handle_type::from_promise(*this);
+
+                if (!coro.done())
+                    coro.resume();
+
+                if (exception_)
+                    std::rethrow_exception(std::exchange(exception_, nullptr));
+            }
+        };
+
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = std::span<const T>;
+            using reference = std::span<const T>;
+            using pointer = void;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            std::span<const T> operator*() const noexcept
+            {
+                return coro_.promise().batch();
+            }
+
+            iterator& operator++()
+            {
+                coro_.promise().advance();
+                return *this;
+            }
+
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept
+            {
+                // last (partial) batch is still available when the body has already completed
+                return !it.coro_ || (it.coro_.done() && it.coro_.promise().batch().empty());
+            }
+
+            friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept
+            {
+                return lhs == std::default_sentinel && rhs == std::default_sentinel;
+            }
+
+        private:
+            handle_type coro_ = nullptr;
+
+            friend batch_generator;
+
+            explicit iterator(handle_type coro) noexcept
+                : coro_{coro}
+            {
+            }
+        };
+
+        batch_generator() = default;
+
+        batch_generator(batch_generator&& other) noexcept
+            : coro_{std::exchange(other.coro_, nullptr)}
+        {
+        }
+
+        batch_generator& operator=(batch_generator other) noexcept
+        {
+            std::swap(coro_, other.coro_);
+            return *this;
+        }
+
+        ~batch_generator()
+        {
+            if (coro_)
+                coro_.destroy();
+        }
+
+        iterator begin()
+        {
+            coro_.promise().advance();
+            return iterator{coro_};
+        }
+
+        iterator end() const noexcept
+        {
+            return {};
+        }
+
+    private:
+        handle_type coro_ = nullptr;
+
+        explicit batch_generator(handle_type coro) noexcept
+            : coro_{coro}
+        {
+        }
+    };
+
+    // range of contiguous batches - batch_generator<T>, std::vector<std::vector<T>>, ...
+    template <typename TBatches>
+    concept BatchRange = std::ranges::input_range<TBatches> && std::ranges::contiguous_range<std::ranges::range_reference_t<TBatches>>;
+
+    //////////////////////////////////////////////////////////////////
+    // unbatch - flattens a range of batches into a range of elements
+    //   for (int n : batches | coro::unbatch) ...
+    //   * the view borrows the batches - an rvalue source is rejected (it would dangle)
+    template <BatchRange TBatches>
+    class UnbatchView : public std::ranges::view_interface<UnbatchView<TBatches>>
+    {
+        using Batch = std::ranges::range_reference_t<TBatches>;
+        using Element = std::ranges::range_reference_t<Batch>;
+
+        TBatches* batches_ = nullptr;
+
+    public:
+        class iterator
+        {
+            std::ranges::iterator_t<TBatches> batch_it_;
+            std::ranges::sentinel_t<TBatches> batch_end_;
+            std::span<std::remove_reference_t<Element>> batch_;
+            std::size_t index_ = 0;
+
+            void load_batch()
+            {
+                batch_ = {};
+                if (batch_it_ != batch_end_)
+                    batch_ = *batch_it_;
+            }
+
+            void skip_empty_batches()
+            {
+                while (batch_.empty() && batch_it_ != batch_end_)
+                {
+                    ++batch_it_;
+                    load_batch();
+                }
+            }
+
+        public:
+            using value_type = std::remove_cvref_t<Element>;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            explicit iterator(TBatches& batches)
+                : batch_it_{std::ranges::begin(batches)}
+                , batch_end_{std::ranges::end(batches)}
+            {
+                load_batch();
+                skip_empty_batches();
+            }
+
+            Element operator*() const
+            {
+                return batch_[index_];
+            }
+
+            iterator& operator++()
+            {
+                if (++index_ == batch_.size())
+                {
+                    index_ = 0;
+                    ++batch_it_;
+                    load_batch();
+                    skip_empty_batches();
+                }
+
+                return *this;
+            }
+
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            friend bool operator==(const iterator& it, std::default_sentinel_t)
+            {
+                return it.batch_it_ == it.batch_end_;
+            }
+        };
+
+        UnbatchView() = default;
+
+        explicit UnbatchView(TBatches& batches)
+            : batches_{&batches}
+        {
+        }
+
+        iterator begin()
+        {
+            return iterator{*batches_};
+        }
+
+        std::default_sentinel_t end() const noexcept
+        {
+            return {};
+        }
+    };
+
+    struct UnbatchFn
+    {
+        template <BatchRange TBatches>
+        auto operator()(TBatches& batches) const
+        {
+            return UnbatchView<TBatches>{batches};
+        }
+    };
+
+    template <BatchRange TBatches>
+    auto operator|(TBatches& batches, const UnbatchFn& fn)
+    {
+        return fn(batches);
+    }
+
+    inline constexpr UnbatchFn unbatch;
+}
+
+#endif //COROUTINES_BATCH_GENERATOR_HPP
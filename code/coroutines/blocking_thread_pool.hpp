@@ -0,0 +1,64 @@
+#ifndef COROUTINES_BLOCKING_THREAD_POOL_HPP
+#define COROUTINES_BLOCKING_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace coro
+{
+    //////////////////////////////////////////////////////////////////
+    // pool of threads for blocking operations (file I/O)
+    class BlockingThreadPool
+    {
+        std::mutex mtx_;
+        std::condition_variable_any work_available_;
+        std::deque<std::function<void()>> jobs_;
+        std::vector<std::jthread> threads_;
+
+        void run(std::stop_token stop)
+        {
+            while (true)
+            {
+                std::function<void()> job;
+
+                {
+                    std::unique_lock lock{mtx_};
+                    if (!work_available_.wait(lock, stop, [this] { return !jobs_.empty(); }))
+                        return;
+
+                    job = std::move(jobs_.front());
+                    jobs_.pop_front();
+                }
+
+                job();
+            }
+        }
+
+    public:
+        explicit BlockingThreadPool(std::size_t thread_count = 2)
+        {
+            for (std::size_t i = 0; i < thread_count; ++i)
+                threads_.emplace_back([this](std::stop_token stop) { run(stop); });
+        }
+
+        BlockingThreadPool(const BlockingThreadPool&) = delete;
+        BlockingThreadPool& operator=(const BlockingThreadPool&) = delete;
+
+        void submit(std::function<void()> job)
+        {
+            {
+                std::lock_guard lock{mtx_};
+                jobs_.push_back(std::move(job));
+            }
+            work_available_.notify_one();
+        }
+    };
+}
+
+#endif //COROUTINES_BLOCKING_THREAD_POOL_HPP
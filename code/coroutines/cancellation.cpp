@@ -0,0 +1,222 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "cancellation.hpp"
+#include "generator.hpp"
+#include "static_thread_pool.hpp"
+#include "sync_wait.hpp"
+#include "task.hpp"
+#include "timer_wheel.hpp"
+#include "when_all.hpp"
+#include <atomic>
+#include <chrono>
+#include <stop_token>
+#include <tuple>
+#include <vector>
+
+using namespace coro;
+using namespace std::chrono_literals;
+
+namespace
+{
+    generator<int> numbers()
+    {
+        for (int i = 0;; ++i)
+            co_yield i;
+    }
+
+    generator<int> numbers_checking(std::stop_token stop_token)
+    {
+        for (int i = 0; !stop_token.stop_requested(); ++i)
+            co_yield i;
+    }
+
+    generator<int> nested_numbers()
+    {
+        co_yield -1;
+        co_yield elements_of(numbers());
+    }
+
+    struct BodyGuard
+    {
+        std::atomic<int>& alive;
+
+        explicit BodyGuard(std::atomic<int>& alive)
+            : alive{alive}
+        {
+            ++alive;
+        }
+
+        ~BodyGuard()
+        {
+            --alive;
+        }
+    };
+
+    task<int> step(std::atomic<int>& steps, std::atomic<int>& alive, std::stop_source& stop_source, int stop_at)
+    {
+        BodyGuard guard{alive};
+
+        if (++steps == stop_at)
+            stop_source.request_stop();
+        co_return 1;
+    }
+
+    task<int> run_steps(static_thread_pool& pool, std::atomic<int>& steps, std::atomic<int>& alive, std::stop_source& stop_source, int stop_at)
+    {
+        BodyGuard guard{alive};
+
+        int sum = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            co_await pool.schedule();
+            sum += co_await step(steps, alive, stop_source, stop_at);
+        }
+        co_return sum;
+    }
+
+    task<bool> has_stop_token()
+    {
+        std::stop_token stop_token = co_await get_stop_token();
+        co_return stop_token.stop_possible();
+    }
+
+    task<bool> nested_has_stop_token()
+    {
+        co_return co_await has_stop_token();
+    }
+
+    task<bool> sleep(TimerWheel& timers, std::chrono::milliseconds duration)
+    {
+        co_return co_await timers.sleep_for(duration, co_await get_stop_token());
+    }
+}
+
+TEST_CASE("cancellation of generators")
+{
+    std::stop_source stop_source;
+
+    SECTION("iteration ends at the next element after a stop is requested")
+    {
+        std::vector<int> values;
+        for (int value : numbers().with_stop_token(stop_source.get_token()))
+        {
+            values.push_back(value);
+            if (value == 4)
+                stop_source.request_stop();
+        }
+
+        REQUIRE(values == std::vector{0, 1, 2, 3, 4});
+    }
+
+    SECTION("stop requested before begin() - empty sequence")
+    {
+        stop_source.request_stop();
+
+        auto g = numbers();
+        g.with_stop_token(stop_source.get_token());
+
+        REQUIRE(g.begin() == g.end());
+    }
+
+    SECTION("token of the outermost generator covers nested generators")
+    {
+        int count = 0;
+        for (int value : nested_numbers().with_stop_token(stop_source.get_token()))
+        {
+            if (++count == 10)
+                stop_source.request_stop();
+            REQUIRE(value < 9);
+        }
+
+        REQUIRE(count == 10);
+    }
+}
+
+TEST_CASE("cancellation of tasks")
+{
+    std::stop_source stop_source;
+    std::atomic<int> steps = 0;
+    std::atomic<int> alive = 0;
+
+    SECTION("task cancelled before it starts never runs")
+    {
+        stop_source.request_stop();
+
+        auto t = step(steps, alive, stop_source, -1).with_stop_token(stop_source.get_token());
+
+        REQUIRE_THROWS_AS(sync_wait(t), operation_cancelled);
+        REQUIRE(steps == 0);
+    }
+
+    SECTION("stop token propagates through awaits - the chain unwinds with operation_cancelled")
+    {
+        static_thread_pool pool{2};
+
+        REQUIRE_THROWS_AS(sync_wait(run_steps(pool, steps, alive, stop_source, 3).with_stop_token(stop_source.get_token())), operation_cancelled);
+
+        REQUIRE(steps == 3);
+        REQUIRE(alive == 0); // frames were unwound
+    }
+
+    SECTION("without a stop request the chain completes")
+    {
+        static_thread_pool pool{2};
+
+        REQUIRE(sync_wait(run_steps(pool, steps, alive, stop_source, -1).with_stop_token(stop_source.get_token())) == 100);
+    }
+
+    SECTION("awaited tasks inherit the token")
+    {
+        REQUIRE_FALSE(sync_wait(nested_has_stop_token()));
+        REQUIRE(sync_wait(nested_has_stop_token().with_stop_token(stop_source.get_token())));
+    }
+
+    SECTION("token passed on to a cancellable operation")
+    {
+        static_thread_pool pool{2};
+        TimerWheel timers{pool};
+
+        auto canceller = [&]() -> task<> {
+            co_await timers.sleep_for(5ms);
+            stop_source.request_stop();
+        };
+
+        auto sleeper = sleep(timers, 1h).with_stop_token(stop_source.get_token());
+        auto [elapsed, cancelled] = sync_wait(when_all(std::move(sleeper), canceller()));
+
+        REQUIRE_FALSE(elapsed);
+    }
+}
+
+TEST_CASE("cancellation - benchmarks", "[.][benchmark]")
+{
+    constexpr int items = 1'000'000;
+
+    auto sum_of = [](auto&& g) {
+        long long sum = 0;
+        for (int value : g)
+        {
+            sum += value;
+            if (value == items)
+                break;
+        }
+        return sum;
+    };
+
+    std::stop_source stop_source;
+
+    BENCHMARK("tight yield loop - no stop token")
+    {
+        return sum_of(numbers());
+    };
+
+    BENCHMARK("tight yield loop - stop token checked by the generator before every resume")
+    {
+        return sum_of(numbers().with_stop_token(stop_source.get_token()));
+    };
+
+    BENCHMARK("tight yield loop - stop token checked in the body")
+    {
+        return sum_of(numbers_checking(stop_source.get_token()));
+    };
+}
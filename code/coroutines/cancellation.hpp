@@ -0,0 +1,97 @@
+#ifndef COROUTINES_CANCELLATION_HPP
+#define COROUTINES_CANCELLATION_HPP
+
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <stop_token>
+#include <utility>
+
+namespace coro
+{
+    //////////////////////////////////////////////////////////////////
+    // cooperative cancellation with std::stop_token
+    //   * task(...).with_stop_token(token) / generator(...).with_stop_token(token)
+    //   * a task passes its token to every task it awaits (unless the awaited task has its own) -
+    //     an awaited task that is cancelled before it starts is never resumed & completes
+    //     with operation_cancelled that propagates up the chain of awaiting tasks
+    //   * a generator checks the token before every resume - the iteration ends
+    //     as if the sequence was exhausted
+    //   * co_await get_stop_token() - the token of the current task
+
+    // thrown by co_await of a task that was cancelled before it started
+    class operation_cancelled : public std::exception
+    {
+    public:
+        const char* what() const noexcept override
+        {
+            return "operation cancelled";
+        }
+    };
+
+    namespace detail
+    {
+        template <typename TPromise>
+        concept StopTokenPromise = requires(TPromise& promise) {
+            { promise.stop_token() } -> std::convertible_to<std::stop_token>;
+        };
+
+        // base of promises of cancellable coroutines
+        class Cancellable
+        {
+            std::stop_token stop_token_;
+
+        public:
+            const std::stop_token& stop_token() const noexcept
+            {
+                return stop_token_;
+            }
+
+            void set_stop_token(std::stop_token stop_token) noexcept
+            {
+                stop_token_ = std::move(stop_token);
+            }
+
+            // an awaited coroutine without its own token inherits the token of the awaiting one
+            template <typename TPromise>
+            void inherit_stop_token(std::coroutine_handle<TPromise> awaiting) noexcept
+            {
+                if constexpr (StopTokenPromise<TPromise>)
+                {
+                    if (!stop_token_.stop_possible())
+                        stop_token_ = awaiting.promise().stop_token();
+                }
+            }
+        };
+
+        struct GetStopTokenAwaiter
+        {
+            std::stop_token stop_token;
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            template <StopTokenPromise TPromise>
+            bool await_suspend(std::coroutine_handle<TPromise> coro) noexcept
+            {
+                stop_token = coro.promise().stop_token();
+                return false; // never suspends
+            }
+
+            std::stop_token await_resume() noexcept
+            {
+                return std::move(stop_token);
+            }
+        };
+    }
+
+    // co_await get_stop_token() - token of the awaiting coroutine (a task)
+    [[nodiscard]] inline detail::GetStopTokenAwaiter get_stop_token() noexcept
+    {
+        return {};
+    }
+}
+
+#endif //COROUTINES_CANCELLATION_HPP
@@ -1,8 +1,12 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include "catch.hpp"
-#include <experimental/generator>
+#include "co_views.hpp"
+#include "generator.hpp"
 #include <numeric>
+#include <string>
+#include <vector>
 
-using namespace std::experimental;
+using namespace coro;
 
 generator<int> gen()
 {
@@ -47,3 +51,67 @@ TEST_CASE("chain of generators")
 
 	REQUIRE(result == 600);
 }
+
+generator<std::string> words()
+{
+    for (int i = 0;; ++i)
+        co_yield std::string(20, static_cast<char>('a' + i % 26));
+}
+
+TEST_CASE("chain of generators - fused with co_views")
+{
+    SECTION("only the source is a coroutine")
+    {
+        auto a = gen()
+            | co_views::take_while([](int x) { return x != 10; })
+            | co_views::transform([](int x) { return x * 10; })
+            | co_views::transform([](int x) { return x + 15; });
+
+        REQUIRE(std::accumulate(a.begin(), a.end(), 0) == 600);
+    }
+
+    SECTION("lvalue source is borrowed")
+    {
+        std::vector<int> source{1, 2, 3, 4, 5};
+
+        auto doubled = source | co_views::transform([](int x) { return 2 * x; });
+        REQUIRE(std::vector<int>(doubled.begin(), doubled.end()) == std::vector{2, 4, 6, 8, 10});
+
+        auto g = gen();
+        auto first_three = g | co_views::take_while([](int x) { return x < 3; });
+        REQUIRE(std::vector<int>(first_three.begin(), first_three.end()) == std::vector{0, 1, 2});
+    }
+
+    SECTION("take_while does not move from yielded rvalues")
+    {
+        auto w = words()
+            | co_views::take_while([](std::string s) { return s[0] != 'd'; })
+            | co_views::transform([](std::string&& s) { return std::move(s); });
+
+        std::vector<std::string> result(w.begin(), w.end());
+        REQUIRE(result == std::vector<std::string>{std::string(20, 'a'), std::string(20, 'b'), std::string(20, 'c')});
+    }
+}
+
+TEST_CASE("chain of generators - benchmarks", "[.][benchmark]")
+{
+    BENCHMARK("gen | take_until | multiply | add - 10'000 items")
+    {
+        auto g = gen();
+        auto t = take_until(g, 10'000);
+        auto m = multiply(t, 10);
+        auto a = add(m, 15);
+
+        return std::accumulate(a.begin(), a.end(), 0LL);
+    };
+
+    BENCHMARK("gen | co_views::take_while | co_views::transform x 2 - 10'000 items")
+    {
+        auto a = gen()
+            | co_views::take_while([](int x) { return x != 10'000; })
+            | co_views::transform([](int x) { return x * 10; })
+            | co_views::transform([](int x) { return x + 15; });
+
+        return std::accumulate(a.begin(), a.end(), 0LL);
+    };
+}
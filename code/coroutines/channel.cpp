@@ -0,0 +1,268 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "channel.hpp"
+#include "static_thread_pool.hpp"
+#include "sync_wait.hpp"
+#include "task.hpp"
+#include "when_all.hpp"
+#include <numeric>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace coro;
+
+namespace
+{
+    task<> produce(static_thread_pool& pool, channel<int>& ch, int first, int count)
+    {
+        co_await pool.schedule();
+        for (int i = first; i < first + count; ++i)
+            co_await ch.send(i);
+    }
+
+    task<long long> consume(static_thread_pool& pool, channel<int>& ch)
+    {
+        co_await pool.schedule();
+        long long sum = 0;
+        while (auto value = co_await ch.receive())
+            sum += *value;
+        co_return sum;
+    }
+
+    // producers_count producers send items_per_producer values each, consumers_count consumers sum them up
+    task<long long> run_producers_consumers(static_thread_pool& pool, channel<int>& ch,
+        int producers_count, int consumers_count, int items_per_producer)
+    {
+        std::vector<task<>> producers;
+        for (int i = 0; i < producers_count; ++i)
+            producers.push_back(produce(pool, ch, i * items_per_producer, items_per_producer));
+
+        std::vector<task<long long>> consumers;
+        for (int i = 0; i < consumers_count; ++i)
+            consumers.push_back(consume(pool, ch));
+
+        auto close_when_produced = [&]() -> task<> {
+            co_await when_all(std::move(producers));
+            ch.close();
+        };
+
+        auto [closed, sums] = co_await when_all(close_when_produced(), when_all(std::move(consumers)));
+        co_return std::accumulate(sums.begin(), sums.end(), 0LL);
+    }
+
+    long long sum_of_range(long long n)
+    {
+        return n * (n - 1) / 2;
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // chain of generators from chain_of_generators.cpp as a pipeline of stages
+    // running on a thread pool & connected with channels
+    task<> gen_stage(static_thread_pool& pool, channel<int>& out)
+    {
+        co_await pool.schedule();
+        for (int i = 0;; ++i)
+            if (!co_await out.send(i))
+                co_return;
+    }
+
+    task<> take_until_stage(static_thread_pool& pool, channel<int>& in, channel<int>& out, int sentinel)
+    {
+        co_await pool.schedule();
+        while (auto value = co_await in.receive())
+        {
+            if (*value == sentinel)
+                break;
+            co_await out.send(*value);
+        }
+        in.close(); // stops the infinite generator
+        out.close();
+    }
+
+    task<> transform_stage(static_thread_pool& pool, channel<int>& in, channel<int>& out, auto op)
+    {
+        co_await pool.schedule();
+        while (auto value = co_await in.receive())
+            co_await out.send(op(*value));
+        out.close();
+    }
+
+    task<long long> pipelined_chain(static_thread_pool& pool, int sentinel, std::size_t capacity)
+    {
+        channel<int> generated{capacity}, taken{capacity}, multiplied{capacity}, added{capacity};
+
+        auto [g, t, m, a, sum] = co_await when_all(
+            gen_stage(pool, generated),
+            take_until_stage(pool, generated, taken, sentinel),
+            transform_stage(pool, taken, multiplied, [](int x) { return x * 10; }),
+            transform_stage(pool, multiplied, added, [](int x) { return x + 15; }),
+            consume(pool, added));
+
+        co_return sum;
+    }
+}
+
+TEST_CASE("channel")
+{
+    channel<std::string> ch{2};
+
+    REQUIRE(ch.capacity() == 2);
+
+    SECTION("values are received in order")
+    {
+        auto test = [&]() -> task<std::vector<std::string>> {
+            co_await ch.send("a");
+            co_await ch.send("b");
+
+            std::vector<std::string> received;
+            received.push_back(*co_await ch.receive());
+            received.push_back(*co_await ch.receive());
+            co_return received;
+        };
+
+        REQUIRE(sync_wait(test()) == std::vector<std::string>{"a", "b"});
+    }
+
+    SECTION("backpressure - sender waits until a value is received")
+    {
+        std::vector<std::string> log;
+
+        auto sender = [&]() -> task<> {
+            for (auto text : {"1", "2", "3"})
+            {
+                co_await ch.send(text);
+                log.push_back(std::string{"sent "} + text);
+            }
+        };
+
+        auto receiver = [&]() -> task<> {
+            log.push_back("receiving");
+            auto value = co_await ch.receive();
+            log.push_back("received " + *value);
+        };
+
+        sync_wait(when_all(sender(), receiver()));
+
+        REQUIRE(log == std::vector<std::string>{"sent 1", "sent 2", "receiving", "sent 3", "received 1"});
+    }
+
+    SECTION("receiver waits until a value is sent")
+    {
+        auto receiver = [&]() -> task<std::string> { co_return *co_await ch.receive(); };
+        auto sender = [&]() -> task<> { co_await ch.send("x"); };
+
+        auto [received, sent] = sync_wait(when_all(receiver(), sender()));
+
+        REQUIRE(received == "x");
+    }
+
+    SECTION("close")
+    {
+        auto test = [&]() -> task<std::tuple<std::optional<std::string>, std::optional<std::string>, bool>> {
+            co_await ch.send("last");
+            ch.close();
+
+            auto last = co_await ch.receive();
+            auto after_last = co_await ch.receive();
+            bool sent_after_close = co_await ch.send("after close");
+            co_return std::tuple{last, after_last, sent_after_close};
+        };
+
+        auto [last, after_last, sent_after_close] = sync_wait(test());
+
+        REQUIRE(last == "last");
+        REQUIRE_FALSE(after_last.has_value());
+        REQUIRE_FALSE(sent_after_close);
+    }
+
+    SECTION("close wakes waiting receivers")
+    {
+        auto receiver = [&]() -> task<bool> { co_return (co_await ch.receive()).has_value(); };
+        auto closer = [&]() -> task<> {
+            ch.close();
+            co_return;
+        };
+
+        auto [received, closed] = sync_wait(when_all(receiver(), closer()));
+
+        REQUIRE_FALSE(received);
+    }
+}
+
+TEST_CASE("channel - multiple producers & consumers")
+{
+    static_thread_pool pool{4};
+    channel<int> ch{16};
+
+    const auto [producers, consumers] = GENERATE(table<int, int>({{1, 1}, {4, 1}, {4, 4}, {1, 4}}));
+    CAPTURE(producers, consumers);
+
+    constexpr int items = 10'000;
+    REQUIRE(sync_wait(run_producers_consumers(pool, ch, producers, consumers, items)) == sum_of_range(producers * items));
+}
+
+TEST_CASE("channel - send racing with close")
+{
+    static_thread_pool pool{3};
+
+    // a receiver gets std::nullopt only after the channel is drained - a send reported as successful is received
+    for (int i = 0; i < 1'000; ++i)
+    {
+        channel<int> ch{4};
+
+        auto sender = [&]() -> task<bool> {
+            co_await pool.schedule();
+            co_return co_await ch.send(i);
+        };
+
+        auto receiver = [&]() -> task<std::optional<int>> {
+            co_await pool.schedule();
+            co_return co_await ch.receive();
+        };
+
+        auto closer = [&]() -> task<> {
+            co_await pool.schedule();
+            ch.close();
+        };
+
+        auto [sent, received, closed] = sync_wait(when_all(sender(), receiver(), closer()));
+
+        CAPTURE(i);
+        if (sent)
+            REQUIRE(received == i);
+    }
+}
+
+TEST_CASE("channel - pipelined chain of generators")
+{
+    static_thread_pool pool{4};
+
+    REQUIRE(sync_wait(pipelined_chain(pool, 10, 4)) == 600);
+    REQUIRE(sync_wait(pipelined_chain(pool, 10'000, 64)) == 10 * sum_of_range(10'000) + 15 * 10'000LL);
+}
+
+TEST_CASE("channel - benchmarks", "[.][benchmark]")
+{
+    constexpr int items = 100'000;
+    const auto thread_count = std::max(2u, std::thread::hardware_concurrency());
+    static_thread_pool pool{thread_count};
+
+    for (auto [producers, consumers] : {std::pair{1, 1}, std::pair{4, 1}, std::pair{4, 4}})
+    {
+        const std::string name = std::to_string(producers) + ":" + std::to_string(consumers) + " - "
+            + std::to_string(producers * items) + " items - capacity 1024";
+
+        BENCHMARK(name.c_str())
+        {
+            channel<int> ch{1024};
+            return sync_wait(run_producers_consumers(pool, ch, producers, consumers, items));
+        };
+    }
+
+    BENCHMARK("pipelined gen | take_until | multiply | add - 10'000 items")
+    {
+        return sync_wait(pipelined_chain(pool, 10'000, 256));
+    };
+}
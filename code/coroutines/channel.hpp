@@ -0,0 +1,463 @@
+#ifndef COROUTINES_CHANNEL_HPP
+#define COROUTINES_CHANNEL_HPP
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace coro
+{
+    namespace detail
+    {
+        //////////////////////////////////////////////////////////////////
+        // bounded lock-free MPMC queue (D. Vyukov)
+        //   * every cell has a sequence number - producers and consumers claim cells
+        //     with a single CAS on their own position counter
+        template <typename T>
+        class BoundedMpmcQueue
+        {
+            struct Cell
+            {
+                std::atomic<std::size_t> sequence;
+                alignas(T) std::byte storage[sizeof(T)];
+
+                T* value() noexcept
+                {
+                    return std::launder(reinterpret_cast<T*>(storage));
+                }
+            };
+
+            static constexpr std::size_t cache_line = 64;
+
+            std::unique_ptr<Cell[]> cells_;
+            std::size_t mask_;
+            alignas(cache_line) std::atomic<std::size_t> enqueue_pos_{0};
+            alignas(cache_line) std::atomic<std::size_t> dequeue_pos_{0};
+
+        public:
+            explicit BoundedMpmcQueue(std::size_t capacity)
+            {
+                std::size_t size = 2;
+                while (size < capacity)
+                    size *= 2;
+
+                cells_ = std::make_unique<Cell[]>(size);
+                mask_ = size - 1;
+                for (std::size_t i = 0; i < size; ++i)
+                    cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+
+            BoundedMpmcQueue(const BoundedMpmcQueue&) = delete;
+            BoundedMpmcQueue& operator=(const BoundedMpmcQueue&) = delete;
+
+            ~BoundedMpmcQueue()
+            {
+                T value;
+                while (try_pop(value))
+                {
+                }
+            }
+
+            std::size_t capacity() const noexcept
+            {
+                return mask_ + 1;
+            }
+
+            // true - every cell claimed by a producer was claimed by a consumer
+            //   * unlike a failed try_pop() it does not report a push in progress as empty
+            bool empty() const noexcept
+            {
+                const std::size_t enqueue_pos = enqueue_pos_.load(std::memory_order_relaxed);
+                return static_cast<std::ptrdiff_t>(dequeue_pos_.load(std::memory_order_relaxed) - enqueue_pos) >= 0;
+            }
+
+            template <typename U>
+            bool try_push(U&& value)
+            {
+                std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+                Cell* cell;
+
+                while (true)
+                {
+                    cell = &cells_[pos & mask_];
+                    const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                    const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+                    if (diff == 0)
+                    {
+                        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            break;
+                    }
+                    else if (diff < 0)
+                        return false; // full
+                    else
+                        pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+
+                ::new (cell->storage) T(std::forward<U>(value));
+                cell->sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+            bool try_pop(T& value)
+            {
+                std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+                Cell* cell;
+
+                while (true)
+                {
+                    cell = &cells_[pos & mask_];
+                    const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                    const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+
+                    if (diff == 0)
+                    {
+                        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            break;
+                    }
+                    else if (diff < 0)
+                        return false; // empty
+                    else
+                        pos = dequeue_pos_.load(std::memory_order_relaxed);
+                }
+
+                value = std::move(*cell->value());
+                std::destroy_at(cell->value());
+                cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+                return true;
+            }
+        };
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // channel<T> - bounded multi-producer multi-consumer channel for coroutines
+    //   * co_await ch.send(value) - suspends while the channel is full (backpressure),
+    //     returns false if the channel is closed (a value racing with close() may still be received)
+    //   * co_await ch.receive() - suspends while the channel is empty,
+    //     returns std::nullopt when the channel is closed and drained
+    //   * fast path: a lock-free MPMC ring buffer - the mutex guarding the waiter lists
+    //     is taken only when a coroutine has to wait or someone is waiting
+    //   * a waiting coroutine is resumed by the thread whose send/receive/close unblocked it
+    template <typename T>
+    class channel
+    {
+        static_assert(std::is_nothrow_move_constructible_v<T> && std::is_default_constructible_v<T>);
+
+        struct Waiter
+        {
+            Waiter* next = nullptr;
+            std::coroutine_handle<> coro;
+            bool closed = false;
+        };
+
+        struct WaiterList
+        {
+            Waiter* head = nullptr;
+            Waiter* tail = nullptr;
+
+            bool empty() const noexcept
+            {
+                return head == nullptr;
+            }
+
+            void push_back(Waiter* waiter) noexcept
+            {
+                waiter->next = nullptr;
+                (tail ? tail->next : head) = waiter;
+                tail = waiter;
+            }
+
+            Waiter* pop_front() noexcept
+            {
+                Waiter* waiter = head;
+                head = head->next;
+                if (!head)
+                    tail = nullptr;
+                return waiter;
+            }
+        };
+
+        detail::BoundedMpmcQueue<T> queue_;
+        std::atomic<bool> closed_{false};
+
+        alignas(64) std::atomic<std::size_t> waiting_{0}; // senders + receivers in the waiter lists
+        std::mutex mtx_;
+        WaiterList senders_;
+        WaiterList receivers_;
+
+    public:
+        class SendOperation : Waiter
+        {
+            channel& channel_;
+            T value_;
+
+            friend channel;
+
+        public:
+            SendOperation(channel& ch, T value)
+                : channel_{ch}
+                , value_{std::move(value)}
+            {
+            }
+
+            bool await_ready()
+            {
+                if (channel_.closed_.load(std::memory_order_relaxed))
+                {
+                    this->closed = true;
+                    return true;
+                }
+
+                if (!channel_.queue_.try_push(std::move(value_)))
+                    return false;
+
+                // close() may have drained the channel before the push - the value is not guaranteed to be received
+                std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in drained_after_close()
+                if (channel_.closed_.load(std::memory_order_relaxed))
+                    this->closed = true;
+
+                channel_.notify_waiters();
+                return true;
+            }
+
+            bool await_suspend(std::coroutine_handle<> coro)
+            {
+                this->coro = coro;
+                return channel_.wait_to_send(*this);
+            }
+
+            // false - the channel was closed and the value was not sent or was sent concurrently with close()
+            bool await_resume() const noexcept
+            {
+                return !this->closed;
+            }
+        };
+
+        class ReceiveOperation : Waiter
+        {
+            channel& channel_;
+            std::optional<T> value_;
+
+            friend channel;
+
+        public:
+            explicit ReceiveOperation(channel& ch) noexcept
+                : channel_{ch}
+            {
+            }
+
+            bool await_ready()
+            {
+                T value;
+                if (!channel_.queue_.try_pop(value))
+                    return channel_.closed_.load(std::memory_order_acquire) && channel_.drained_after_close(value_);
+
+                value_.emplace(std::move(value));
+                channel_.notify_waiters();
+                return true;
+            }
+
+            bool await_suspend(std::coroutine_handle<> coro)
+            {
+                this->coro = coro;
+                return channel_.wait_to_receive(*this);
+            }
+
+            // std::nullopt - the channel is closed and empty
+            std::optional<T> await_resume() noexcept
+            {
+                return std::move(value_);
+            }
+        };
+
+        explicit channel(std::size_t capacity)
+            : queue_{capacity}
+        {
+        }
+
+        channel(const channel&) = delete;
+        channel& operator=(const channel&) = delete;
+
+        std::size_t capacity() const noexcept
+        {
+            return queue_.capacity();
+        }
+
+        [[nodiscard]] SendOperation send(T value)
+        {
+            return SendOperation{*this, std::move(value)};
+        }
+
+        [[nodiscard]] ReceiveOperation receive() noexcept
+        {
+            return ReceiveOperation{*this};
+        }
+
+        // wakes all waiting coroutines - pending senders get false, receivers drain the remaining values
+        void close()
+        {
+            WaiterList to_resume;
+
+            {
+                std::lock_guard lock{mtx_};
+                closed_.store(true, std::memory_order_seq_cst);
+
+                while (!senders_.empty())
+                {
+                    Waiter* sender = senders_.pop_front();
+                    sender->closed = true;
+                    to_resume.push_back(sender);
+                }
+
+                while (!receivers_.empty())
+                {
+                    auto* receiver = static_cast<ReceiveOperation*>(receivers_.pop_front());
+                    drained_after_close(receiver->value_);
+                    to_resume.push_back(receiver);
+                }
+
+                waiting_.store(0, std::memory_order_relaxed);
+            }
+
+            resume_all(to_resume);
+        }
+
+    private:
+        // a value pushed just before close() may still be in the queue
+        //   * a push that did not see closed_ is visible after the fence - waits until it is written
+        bool drained_after_close(std::optional<T>& result)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in SendOperation::await_ready()
+
+            T value;
+            while (!queue_.try_pop(value))
+            {
+                if (queue_.empty())
+                    return true;
+                std::this_thread::yield();
+            }
+
+            result.emplace(std::move(value));
+            return true;
+        }
+
+        static void resume_all(WaiterList& list)
+        {
+            while (!list.empty())
+                list.pop_front()->coro.resume();
+        }
+
+        bool wait_to_send(SendOperation& op)
+        {
+            {
+                std::lock_guard lock{mtx_};
+
+                waiting_.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in notify_waiters()
+
+                if (closed_.load(std::memory_order_relaxed))
+                {
+                    waiting_.fetch_sub(1, std::memory_order_relaxed);
+                    op.closed = true;
+                    return false;
+                }
+
+                if (!queue_.try_push(std::move(op.value_)))
+                {
+                    senders_.push_back(&op);
+                    return true;
+                }
+
+                waiting_.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            notify_waiters();
+            return false;
+        }
+
+        bool wait_to_receive(ReceiveOperation& op)
+        {
+            {
+                std::lock_guard lock{mtx_};
+
+                waiting_.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in notify_waiters()
+
+                T value;
+                if (!queue_.try_pop(value))
+                {
+                    if (closed_.load(std::memory_order_relaxed))
+                    {
+                        waiting_.fetch_sub(1, std::memory_order_relaxed);
+                        return !drained_after_close(op.value_);
+                    }
+
+                    receivers_.push_back(&op);
+                    return true;
+                }
+
+                waiting_.fetch_sub(1, std::memory_order_relaxed);
+                op.value_.emplace(std::move(value));
+            }
+
+            notify_waiters();
+            return false;
+        }
+
+        // after a successful push or pop: completes operations of waiting coroutines that can proceed now
+        void notify_waiters()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiting_.load(std::memory_order_relaxed) == 0)
+                return;
+
+            WaiterList to_resume;
+
+            {
+                std::lock_guard lock{mtx_};
+
+                for (bool progress = true; progress;)
+                {
+                    progress = false;
+
+                    while (!receivers_.empty())
+                    {
+                        auto* receiver = static_cast<ReceiveOperation*>(receivers_.head);
+                        T value;
+                        if (!queue_.try_pop(value))
+                            break;
+
+                        receiver->value_.emplace(std::move(value));
+                        to_resume.push_back(receivers_.pop_front());
+                        waiting_.fetch_sub(1, std::memory_order_relaxed);
+                        progress = true;
+                    }
+
+                    while (!senders_.empty())
+                    {
+                        auto* sender = static_cast<SendOperation*>(senders_.head);
+                        if (!queue_.try_push(std::move(sender->value_)))
+                            break;
+
+                        to_resume.push_back(senders_.pop_front());
+                        waiting_.fetch_sub(1, std::memory_order_relaxed);
+                        progress = true;
+                    }
+                }
+            }
+
+            resume_all(to_resume);
+        }
+    };
+}
+
+#endif //COROUTINES_CHANNEL_HPP
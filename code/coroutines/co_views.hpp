@@ -0,0 +1,232 @@
+#ifndef COROUTINES_CO_VIEWS_HPP
+#define COROUTINES_CO_VIEWS_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+namespace coro::co_views
+{
+    //////////////////////////////////////////////////////////////////
+    // fused stages over a generator - only the source is a coroutine
+    //   auto a = gen() | co_views::take_while(pred) | co_views::transform(f);
+    //   * a stage is a plain function call inlined into operator* / operator++ -
+    //     no extra coroutine frame & no extra resume per element
+    //   * an rvalue source (e.g. a generator) is moved into the view, an lvalue is borrowed
+    //   * begin() & end() have the same type - works with classic algorithms (std::accumulate)
+    //   * single-pass like generator - begin() may be called once
+
+    template <std::ranges::input_range TBase, std::copy_constructible F>
+        requires std::ranges::view<TBase> && std::regular_invocable<F&, std::ranges::range_reference_t<TBase>>
+    class TransformView : public std::ranges::view_interface<TransformView<TBase, F>>
+    {
+        TBase base_;
+        [[no_unique_address]] F f_;
+
+    public:
+        class iterator
+        {
+            TransformView* parent_ = nullptr;
+            std::ranges::iterator_t<TBase> it_{};
+
+            bool at_end() const
+            {
+                return !parent_ || it_ == std::ranges::end(parent_->base_);
+            }
+
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using reference = std::invoke_result_t<F&, std::ranges::range_reference_t<TBase>>;
+            using value_type = std::remove_cvref_t<reference>;
+            using pointer = void;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            iterator(TransformView& parent, std::ranges::iterator_t<TBase> it)
+                : parent_{&parent}
+                , it_{std::move(it)}
+            {
+            }
+
+            reference operator*() const
+            {
+                return std::invoke(parent_->f_, *it_);
+            }
+
+            iterator& operator++()
+            {
+                ++it_;
+                return *this;
+            }
+
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            friend bool operator==(const iterator& it, std::default_sentinel_t)
+            {
+                return it.at_end();
+            }
+
+            friend bool operator==(const iterator& lhs, const iterator& rhs)
+            {
+                return lhs == std::default_sentinel && rhs == std::default_sentinel;
+            }
+        };
+
+        TransformView() = default;
+
+        TransformView(TBase base, F f)
+            : base_{std::move(base)}
+            , f_{std::move(f)}
+        {
+        }
+
+        iterator begin()
+        {
+            return iterator{*this, std::ranges::begin(base_)};
+        }
+
+        iterator end() const noexcept
+        {
+            return {};
+        }
+    };
+
+    template <std::ranges::input_range TBase, std::copy_constructible TPredicate>
+        requires std::ranges::view<TBase>
+            && std::predicate<TPredicate&, const std::remove_reference_t<std::ranges::range_reference_t<TBase>>&>
+    class TakeWhileView : public std::ranges::view_interface<TakeWhileView<TBase, TPredicate>>
+    {
+        TBase base_;
+        [[no_unique_address]] TPredicate predicate_;
+
+    public:
+        class iterator
+        {
+            TakeWhileView* parent_ = nullptr;
+            std::ranges::iterator_t<TBase> it_{};
+            bool done_ = true;
+
+            // the predicate sees a const lvalue - an rvalue reference yielded by a generator is not moved from
+            void check()
+            {
+                done_ = it_ == std::ranges::end(parent_->base_);
+                if (!done_)
+                {
+                    auto&& value = *it_;
+                    done_ = !std::invoke(parent_->predicate_, std::as_const(value));
+                }
+            }
+
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using reference = std::ranges::range_reference_t<TBase>;
+            using value_type = std::ranges::range_value_t<TBase>;
+            using pointer = void;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            iterator(TakeWhileView& parent, std::ranges::iterator_t<TBase> it)
+                : parent_{&parent}
+                , it_{std::move(it)}
+            {
+                check();
+            }
+
+            reference operator*() const
+            {
+                return *it_;
+            }
+
+            iterator& operator++()
+            {
+                ++it_;
+                check();
+                return *this;
+            }
+
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept
+            {
+                return it.done_;
+            }
+
+            friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept
+            {
+                return lhs.done_ && rhs.done_;
+            }
+        };
+
+        TakeWhileView() = default;
+
+        TakeWhileView(TBase base, TPredicate predicate)
+            : base_{std::move(base)}
+            , predicate_{std::move(predicate)}
+        {
+        }
+
+        iterator begin()
+        {
+            return iterator{*this, std::ranges::begin(base_)};
+        }
+
+        iterator end() const noexcept
+        {
+            return {};
+        }
+    };
+
+    namespace detail
+    {
+        // std::views::all() - plus a borrowed lvalue of a move-only view (generator is not viewable_range)
+        template <typename TRange>
+            requires std::ranges::viewable_range<TRange> || (std::is_lvalue_reference_v<TRange> && std::ranges::input_range<TRange>)
+        auto as_view(TRange&& range)
+        {
+            if constexpr (std::ranges::viewable_range<TRange>)
+                return std::views::all(std::forward<TRange>(range));
+            else
+                return std::ranges::ref_view{range};
+        }
+
+        template <template <typename...> typename TView, typename TFunction>
+        struct Closure
+        {
+            TFunction function;
+
+            template <typename TRange>
+                requires requires(TRange&& range) { as_view(std::forward<TRange>(range)); }
+            friend auto operator|(TRange&& range, Closure closure)
+            {
+                using Base = decltype(as_view(std::forward<TRange>(range)));
+                return TView<Base, TFunction>{as_view(std::forward<TRange>(range)), std::move(closure.function)};
+            }
+        };
+    }
+
+    template <typename F>
+    auto transform(F f)
+    {
+        return detail::Closure<TransformView, F>{std::move(f)};
+    }
+
+    template <typename TPredicate>
+    auto take_while(TPredicate predicate)
+    {
+        return detail::Closure<TakeWhileView, TPredicate>{std::move(predicate)};
+    }
+}
+
+#endif //COROUTINES_CO_VIEWS_HPP
@@ -1,9 +1,10 @@
 #include "catch.hpp"
-#include <experimental/generator>
+#include "generator.hpp"
+#include <coroutine>
 #include <iostream>
 #include <string>
 
-using namespace std::experimental;
+using namespace coro;
 
 ///////////////////////////////
 // the simplest coroutine
@@ -16,12 +17,13 @@ namespace explain
             return true;
         }
 
-        void await_suspend(coroutine_handle<>) noexcept { }
+        void await_suspend(std::coroutine_handle<>) noexcept { }
 
         void await_resume() noexcept { }
     };
 }
 
+#ifdef _MSC_VER // coroutine with deduced return type is an MSVC extension
 auto the_simplest_coroutine()
 {
     co_await explain::suspend_never{};
@@ -31,6 +33,7 @@ TEST_CASE("the simplest coroutine")
 {
     the_simplest_coroutine();
 }
+#endif
 
 
 generator<char> hello()
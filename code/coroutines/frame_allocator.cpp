@@ -0,0 +1,166 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "frame_allocator.hpp"
+#include "generator.hpp"
+#include "pipeline_stages.hpp"
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <vector>
+
+using namespace coro;
+using namespace pipeline_stages;
+
+namespace
+{
+    template <typename T>
+    struct CountingAllocator
+    {
+        using value_type = T;
+
+        size_t* allocated_bytes;
+
+        CountingAllocator(size_t* counter) noexcept
+            : allocated_bytes{counter}
+        {
+        }
+
+        template <typename U>
+        CountingAllocator(const CountingAllocator<U>& other) noexcept
+            : allocated_bytes{other.allocated_bytes}
+        {
+        }
+
+        T* allocate(size_t n)
+        {
+            *allocated_bytes += n * sizeof(T);
+            return std::allocator<T>{}.allocate(n);
+        }
+
+        void deallocate(T* ptr, size_t n) noexcept
+        {
+            *allocated_bytes -= n * sizeof(T);
+            std::allocator<T>{}.deallocate(ptr, n);
+        }
+
+        bool operator==(const CountingAllocator&) const = default;
+    };
+
+    // GCC pairs the templated allocator_arg operator new with the plain sized operator delete
+    // and warns at every coroutine using it - the pairing is intended (see FrameAllocation)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+    // stage(args...) nested in a generator whose frame comes from the allocator
+    //   * lvalue arguments are passed with std::ref - the stage starts at the first resume
+    template <typename TAllocator, typename... TParams, typename... TArgs>
+    generator<int> allocated(std::allocator_arg_t, TAllocator, generator<int> (*stage)(TParams...), TArgs... args)
+    {
+        co_yield elements_of(stage(args...));
+    }
+
+    struct Counter
+    {
+        int start;
+
+        template <typename TAllocator>
+        generator<int> count(std::allocator_arg_t, TAllocator, int n) const
+        {
+            for (int i = start; i < start + n; ++i)
+                co_yield i;
+        }
+    };
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+    template <typename TAllocator>
+    int run_pipeline(const TAllocator& allocator, int sentinel)
+    {
+        auto g = allocated(std::allocator_arg, allocator, numbers);
+        auto t = allocated(std::allocator_arg, allocator, take_until, std::ref(g), sentinel);
+        auto m = allocated(std::allocator_arg, allocator, multiply, std::ref(t), 10);
+        auto a = allocated(std::allocator_arg, allocator, add, std::ref(m), 15);
+
+        return std::accumulate(a.begin(), a.end(), 0);
+    }
+}
+
+TEST_CASE("frame allocation - default frame pool")
+{
+    const FrameStatistics before = frame_statistics();
+
+    REQUIRE(sum_of_chain(10) == 600);
+
+    const FrameStatistics after_first = frame_statistics();
+    REQUIRE(after_first.allocations - before.allocations == 4);
+    REQUIRE(after_first.deallocations - before.deallocations == 4);
+    REQUIRE(after_first.alive() == before.alive());
+
+    SECTION("released frames are reused")
+    {
+        REQUIRE(sum_of_chain(10) == 600);
+
+        REQUIRE(frame_statistics().pool_hits - after_first.pool_hits == 4);
+    }
+}
+
+TEST_CASE("frame allocation - allocator_arg")
+{
+    SECTION("custom allocator")
+    {
+        size_t allocated_bytes = 0;
+        CountingAllocator<std::byte> allocator{&allocated_bytes};
+
+        {
+            auto g = allocated(std::allocator_arg, allocator, numbers);
+            REQUIRE(allocated_bytes > 0);
+            REQUIRE(*g.begin() == 0);
+        }
+
+        REQUIRE(allocated_bytes == 0);
+    }
+
+    SECTION("member coroutine")
+    {
+        size_t allocated_bytes = 0;
+        Counter counter{5};
+
+        auto g = counter.count(std::allocator_arg, CountingAllocator<int>{&allocated_bytes}, 3);
+        REQUIRE(allocated_bytes > 0);
+        REQUIRE(std::ranges::equal(g, std::vector{5, 6, 7}));
+    }
+
+    SECTION("arena - pmr::monotonic_buffer_resource")
+    {
+        std::array<std::byte, 4096> buffer;
+        std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+        REQUIRE(run_pipeline(std::pmr::polymorphic_allocator<>{&arena}, 10) == 600);
+    }
+}
+
+TEST_CASE("frame allocation - benchmarks", "[.][benchmark]")
+{
+    BENCHMARK("pipeline construction - frame pool")
+    {
+        return sum_of_chain(1);
+    };
+
+    BENCHMARK("pipeline construction - global operator new")
+    {
+        return run_pipeline(std::allocator<std::byte>{}, 1);
+    };
+
+    BENCHMARK_ADVANCED("pipeline construction - pmr::monotonic_buffer_resource")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<std::byte> buffer(4096 * meter.runs());
+        std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size()};
+
+        meter.measure([&] { return run_pipeline(std::pmr::polymorphic_allocator<>{&arena}, 1); });
+    };
+}
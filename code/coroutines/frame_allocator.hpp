@@ -0,0 +1,240 @@
+#ifndef COROUTINES_FRAME_ALLOCATOR_HPP
+#define COROUTINES_FRAME_ALLOCATOR_HPP
+
+#include "instrumentation.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace coro
+{
+    //////////////////////////////////////////////////////////////////
+    // statistics of coroutine frame allocations made by the current thread
+    struct FrameStatistics
+    {
+        std::size_t allocations{};
+        std::size_t deallocations{};
+        std::size_t pool_hits{}; // allocations served from the frame pool free lists
+        std::size_t bytes{};     // total size of allocated frames
+
+        std::size_t alive() const
+        {
+            return allocations - deallocations;
+        }
+    };
+
+    inline FrameStatistics& frame_statistics() noexcept
+    {
+        thread_local FrameStatistics stats;
+        return stats;
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // thread-local pool of coroutine frames
+    //   * size classes of 64 bytes up to 1 KiB - larger frames go to the global operator new
+    //   * released frames are cached on the free list of the releasing thread
+    class FramePool
+    {
+        static constexpr std::size_t granularity = 64;
+        static constexpr std::size_t class_count = 16;
+        static constexpr std::size_t max_cached = 256; // per size class
+
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        struct FreeList
+        {
+            FreeBlock* head = nullptr;
+            std::size_t size = 0;
+        };
+
+        std::array<FreeList, class_count> free_lists_{};
+
+        static constexpr std::size_t size_class(std::size_t size) noexcept
+        {
+            return (size - 1) / granularity;
+        }
+
+    public:
+        FramePool() = default;
+        FramePool(const FramePool&) = delete;
+        FramePool& operator=(const FramePool&) = delete;
+
+        ~FramePool()
+        {
+            for (FreeList& list : free_lists_)
+            {
+                while (list.head)
+                    ::operator delete(std::exchange(list.head, list.head->next));
+            }
+        }
+
+        static FramePool& local() noexcept
+        {
+            thread_local FramePool pool;
+            return pool;
+        }
+
+        void* allocate(std::size_t size)
+        {
+            const std::size_t index = size_class(size);
+
+            if (index >= class_count)
+                return ::operator new(size);
+
+            FreeList& list = free_lists_[index];
+
+            if (!list.head)
+                return ::operator new((index + 1) * granularity);
+
+            ++frame_statistics().pool_hits;
+            --list.size;
+            return std::exchange(list.head, list.head->next);
+        }
+
+        void deallocate(void* ptr, std::size_t size) noexcept
+        {
+            const std::size_t index = size_class(size);
+
+            if (index >= class_count || free_lists_[index].size == max_cached)
+            {
+                ::operator delete(ptr);
+                return;
+            }
+
+            FreeList& list = free_lists_[index];
+            list.head = ::new (ptr) FreeBlock{list.head};
+            ++list.size;
+        }
+    };
+
+    namespace detail
+    {
+        // allocated frame: [ coroutine frame | padding | deallocate function | allocator (optional) ]
+        using DeallocateFn = void (*)(void* frame, std::size_t frame_size) noexcept;
+
+        constexpr std::size_t trailer_offset(std::size_t frame_size) noexcept
+        {
+            constexpr std::size_t alignment = alignof(std::max_align_t);
+            return (frame_size + alignment - 1) & ~(alignment - 1);
+        }
+
+        inline DeallocateFn& deallocate_fn_of(void* frame, std::size_t frame_size) noexcept
+        {
+            return *std::launder(reinterpret_cast<DeallocateFn*>(static_cast<std::byte*>(frame) + trailer_offset(frame_size)));
+        }
+
+        inline void deallocate_pooled(void* frame, std::size_t frame_size) noexcept
+        {
+            FramePool::local().deallocate(frame, trailer_offset(frame_size) + sizeof(DeallocateFn));
+        }
+
+        inline void* allocate_pooled(std::size_t frame_size)
+        {
+            void* frame = FramePool::local().allocate(trailer_offset(frame_size) + sizeof(DeallocateFn));
+            ::new (&deallocate_fn_of(frame, frame_size)) DeallocateFn{&deallocate_pooled};
+            return frame;
+        }
+
+        struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) AlignedBlock
+        {
+            std::byte bytes[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+        };
+
+        template <typename TAllocator>
+        struct AllocatorTrailer
+        {
+            DeallocateFn deallocate; // must stay the first member
+            TAllocator allocator;
+        };
+
+        template <typename TBlockAllocator>
+        constexpr std::size_t block_count(std::size_t frame_size) noexcept
+        {
+            const std::size_t total = trailer_offset(frame_size) + sizeof(AllocatorTrailer<TBlockAllocator>);
+            return (total + sizeof(AlignedBlock) - 1) / sizeof(AlignedBlock);
+        }
+
+        template <typename TBlockAllocator>
+        void deallocate_with_allocator(void* frame, std::size_t frame_size) noexcept
+        {
+            using Trailer = AllocatorTrailer<TBlockAllocator>;
+
+            auto* trailer = std::launder(reinterpret_cast<Trailer*>(static_cast<std::byte*>(frame) + trailer_offset(frame_size)));
+            TBlockAllocator allocator = std::move(trailer->allocator);
+            trailer->~Trailer();
+
+            std::allocator_traits<TBlockAllocator>::deallocate(allocator, static_cast<AlignedBlock*>(frame), block_count<TBlockAllocator>(frame_size));
+        }
+
+        template <typename TAllocator>
+        void* allocate_with_allocator(std::size_t frame_size, const TAllocator& allocator)
+        {
+            using BlockAllocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<AlignedBlock>;
+            using Trailer = AllocatorTrailer<BlockAllocator>;
+
+            static_assert(alignof(Trailer) <= alignof(std::max_align_t));
+
+            BlockAllocator block_allocator(allocator);
+            void* frame = std::allocator_traits<BlockAllocator>::allocate(block_allocator, block_count<BlockAllocator>(frame_size));
+
+            ::new (static_cast<std::byte*>(frame) + trailer_offset(frame_size))
+                Trailer{&deallocate_with_allocator<BlockAllocator>, std::move(block_allocator)};
+
+            return frame;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // base class of promise types - controls allocation of coroutine frames
+    //   * coroutine(args...) - frame from the thread-local FramePool
+    //   * coroutine(std::allocator_arg, alloc, args...) - frame allocated with alloc
+    //     (for member coroutines: obj.coroutine(std::allocator_arg, alloc, args...))
+    //   * every frame is released by the sized operator delete - the frame's trailer knows its allocator;
+    //     GCC 12 reports the allocator_arg pairing as -Wmismatched-new-delete at the coroutine definition,
+    //     so the warning can only be silenced there
+    struct FrameAllocation
+    {
+        static void* operator new(std::size_t frame_size)
+        {
+            count_allocation(frame_size);
+            return detail::allocate_pooled(frame_size);
+        }
+
+        template <typename TAllocator, typename... TArgs>
+        static void* operator new(std::size_t frame_size, std::allocator_arg_t, const TAllocator& allocator, const TArgs&...)
+        {
+            count_allocation(frame_size);
+            return detail::allocate_with_allocator(frame_size, allocator);
+        }
+
+        template <typename TThis, typename TAllocator, typename... TArgs>
+        static void* operator new(std::size_t frame_size, const TThis&, std::allocator_arg_t, const TAllocator& allocator, const TArgs&...)
+        {
+            count_allocation(frame_size);
+            return detail::allocate_with_allocator(frame_size, allocator);
+        }
+
+        static void operator delete(void* frame, std::size_t frame_size) noexcept
+        {
+            ++frame_statistics().deallocations;
+            detail::deallocate_fn_of(frame, frame_size)(frame, frame_size);
+        }
+
+    private:
+        static void count_allocation(std::size_t frame_size) noexcept
+        {
+            FrameStatistics& stats = frame_statistics();
+            ++stats.allocations;
+            stats.bytes += frame_size;
+            detail::record_frame_size(frame_size);
+        }
+    };
+}
+
+#endif //COROUTINES_FRAME_ALLOCATOR_HPP
@@ -0,0 +1,228 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "generator.hpp"
+#include <algorithm>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace coro;
+
+static_assert(std::ranges::input_range<generator<int>>);
+static_assert(std::ranges::view<generator<int>>);
+static_assert(std::ranges::common_range<generator<int>>);
+static_assert(std::same_as<std::ranges::range_reference_t<generator<int>>, int&&>);
+static_assert(std::same_as<std::ranges::range_reference_t<generator<const std::string&>>, const std::string&>);
+static_assert(std::same_as<std::ranges::range_value_t<generator<const std::string&>>, std::string>);
+
+namespace
+{
+    generator<int> iota(int first, int last)
+    {
+        for (int i = first; i < last; ++i)
+            co_yield i;
+    }
+
+    generator<const std::string&> words()
+    {
+        std::string word = "one";
+        co_yield word;
+        word = "two";
+        co_yield word;
+    }
+
+    generator<int> throwing(int count)
+    {
+        for (int i = 0; i < count; ++i)
+            co_yield i;
+        throw std::runtime_error{"error #" + std::to_string(count)};
+    }
+
+    generator<int> concat()
+    {
+        co_yield 0;
+        co_yield elements_of(iota(1, 3));
+        co_yield elements_of(iota(3, 3)); // empty
+        co_yield elements_of(std::views::iota(3, 5));
+        co_yield 5;
+    }
+
+    generator<int> tree(int depth)
+    {
+        if (depth == 0)
+        {
+            co_yield 1;
+            co_return;
+        }
+
+        co_yield elements_of(tree(depth - 1));
+        co_yield elements_of(tree(depth - 1));
+    }
+
+    // depth stages that pass the values of the innermost one
+    generator<int> nested_chain(int depth, int count)
+    {
+        if (depth == 0)
+        {
+            for (int i = 0; i < count; ++i)
+                co_yield i;
+        }
+        else
+        {
+            co_yield elements_of(nested_chain(depth - 1, count));
+        }
+    }
+
+    generator<int> looped_chain(int depth, int count)
+    {
+        if (depth == 0)
+        {
+            for (int i = 0; i < count; ++i)
+                co_yield i;
+        }
+        else
+        {
+            for (int value : looped_chain(depth - 1, count))
+                co_yield value;
+        }
+    }
+}
+
+TEST_CASE("generator")
+{
+    SECTION("values")
+    {
+        std::vector<int> result;
+        for (int i : iota(0, 5))
+            result.push_back(i);
+
+        REQUIRE(result == std::vector{0, 1, 2, 3, 4});
+    }
+
+    SECTION("references")
+    {
+        std::vector<std::string> result;
+        for (const std::string& w : words())
+            result.push_back(w);
+
+        REQUIRE(result == std::vector<std::string>{"one", "two"});
+    }
+
+    SECTION("lvalue yielded to generator<T> is copied")
+    {
+        auto lvalues = []() -> generator<std::string> {
+            std::string text = "text";
+            co_yield text;
+            co_yield text;
+        };
+
+        std::vector<std::string> result;
+        for (std::string&& s : lvalues())
+            result.push_back(std::move(s));
+
+        REQUIRE(result == std::vector<std::string>{"text", "text"});
+    }
+
+    SECTION("range adaptors")
+    {
+        auto evens = iota(0, 10) | std::views::filter([](int n) { return n % 2 == 0; }) | std::views::take(3);
+
+        REQUIRE(std::ranges::equal(evens, std::vector{0, 2, 4}));
+    }
+}
+
+TEST_CASE("generator - nested generators")
+{
+    SECTION("elements_of")
+    {
+        REQUIRE(std::ranges::equal(concat(), std::vector{0, 1, 2, 3, 4, 5}));
+    }
+
+    SECTION("recursion")
+    {
+        auto g = tree(4);
+        REQUIRE(std::ranges::distance(g.begin(), g.end()) == 16);
+    }
+
+    SECTION("deep nesting")
+    {
+        auto g = nested_chain(1'000, 3);
+        REQUIRE(std::ranges::equal(g, std::vector{0, 1, 2}));
+    }
+
+    SECTION("lvalue nested generator")
+    {
+        auto inner = iota(1, 3);
+        auto outer = [](generator<int>& g) -> generator<int> {
+            co_yield 0;
+            co_yield elements_of(g);
+        };
+
+        REQUIRE(std::ranges::equal(outer(inner), std::vector{0, 1, 2}));
+    }
+
+    SECTION("exceptions from nested generators")
+    {
+        auto outer = []() -> generator<int> {
+            bool failed = false;
+
+            try
+            {
+                co_yield elements_of(throwing(2));
+            }
+            catch (const std::runtime_error&)
+            {
+                failed = true;
+            }
+
+            if (failed)
+                co_yield -1;
+        };
+
+        REQUIRE(std::ranges::equal(outer(), std::vector{0, 1, -1}));
+    }
+}
+
+TEST_CASE("generator - exceptions")
+{
+    SECTION("thrown from operator++")
+    {
+        auto g = throwing(2);
+        auto it = g.begin();
+        REQUIRE(*it == 0);
+        ++it;
+        REQUIRE(*it == 1);
+        REQUIRE_THROWS_AS(++it, std::runtime_error);
+    }
+
+    SECTION("thrown from begin()")
+    {
+        auto g = throwing(0);
+        REQUIRE_THROWS_WITH(g.begin(), "error #0");
+    }
+}
+
+TEST_CASE("generator - nested chain benchmarks", "[.][benchmark]")
+{
+    const int count = 10'000;
+
+    for (int depth : {1, 4, 16, 64})
+    {
+        BENCHMARK("depth " + std::to_string(depth) + " - co_yield elements_of (symmetric transfer)")
+        {
+            long long sum{};
+            for (int value : nested_chain(depth, count))
+                sum += value;
+            return sum;
+        };
+
+        BENCHMARK("depth " + std::to_string(depth) + " - for + co_yield in every stage")
+        {
+            long long sum{};
+            for (int value : looped_chain(depth, count))
+                sum += value;
+            return sum;
+        };
+    }
+}
@@ -0,0 +1,346 @@
+#ifndef COROUTINES_GENERATOR_HPP
+#define COROUTINES_GENERATOR_HPP
+
+#include "cancellation.hpp"
+#include "frame_allocator.hpp"
+#include "instrumentation.hpp"
+
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
+
+namespace coro
+{
+    //////////////////////////////////////////////////////////////////
+    // co_yield elements_of(rng) - yields all elements of a nested range/generator
+    template <typename TRange>
+    struct elements_of
+    {
+        TRange range;
+    };
+
+    template <typename TRange>
+    elements_of(TRange&&) -> elements_of<TRange&&>;
+
+    //////////////////////////////////////////////////////////////////
+    // generator<Ref, V> - portable replacement of std::experimental::generator
+    //   * lazy - body starts on begin()
+    //   * models std::ranges::input_range & std::ranges::view
+    //   * begin() & end() have the same type - works with classic algorithms (std::accumulate)
+    //   * exceptions thrown in the body are rethrown from begin()/operator++
+    //   * frames come from the thread-local FramePool or from an allocator
+    //     passed as generator(std::allocator_arg, alloc, args...)
+    //   * reference/value types follow std::generator (C++23):
+    //       generator<int> yields int&&, generator<const std::string&> yields const std::string&
+    //   * cancellable - with_stop_token(token) ends the iteration at the next element
+    //     (the token of the outermost generator covers the generators nested with elements_of)
+    template <typename Ref, typename V = void>
+    class generator : public std::ranges::view_interface<generator<Ref, V>>
+    {
+        using value = std::conditional_t<std::is_void_v<V>, std::remove_cvref_t<Ref>, V>;
+        using reference = std::conditional_t<std::is_void_v<V>, Ref&&, Ref>;
+        using yielded = std::conditional_t<std::is_reference_v<reference>, reference, const reference&>;
+
+    public:
+        class promise_type;
+        class iterator;
+
+    private:
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        template <typename TGenerator>
+        struct NestedAwaiter
+        {
+            TGenerator nested; // generator (owned) or generator& (borrowed)
+
+            bool await_ready() const noexcept
+            {
+                return !nested.coro_;
+            }
+
+            // symmetric transfer to the nested generator - it becomes the active leaf of the root
+            std::coroutine_handle<> await_suspend(handle_type outer) noexcept
+            {
+                promise_type& inner = nested.coro_.promise();
+                inner.root_ = outer.promise().root_;
+                inner.parent_ = outer;
+                inner.root_->active_ = nested.coro_;
+
+                return nested.coro_;
+            }
+
+            void await_resume()
+            {
+                if (nested.coro_)
+                    nested.coro_.promise().rethrow_if_exception();
+            }
+        };
+
+    public:
+        // nested generators form a stack:
+        //   * root_ - outermost generator iterated by the caller; it stores the current value
+        //     and the active_ leaf - the innermost generator that is resumed by operator++
+        //   * parent_ - generator that is resumed (symmetric transfer) when a nested one completes
+        // so every element costs a single resume regardless of the nesting depth
+        class promise_type : public FrameAllocation, public PromiseInstrumentation, public detail::Cancellable
+        {
+            std::add_pointer_t<yielded> value_ = nullptr;
+            std::exception_ptr exception_;
+            bool cancelled_ = false;
+            promise_type* root_ = this;
+            handle_type active_ = handle_type::from_promise(*this);
+            handle_type parent_;
+
+            friend generator;
+
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(handle_type finished) noexcept
+                {
+                    promise_type& promise = finished.promise();
+
+                    if (!promise.parent_)
+                        return std::noop_coroutine();
+
+                    promise.root_->active_ = promise.parent_;
+                    return promise.parent_;
+                }
+
+                void await_resume() const noexcept
+                {
+                }
+            };
+
+        public:
+            promise_type(detail::CoroutineLocation location = detail::CoroutineLocation::current())
+                : PromiseInstrumentation{location}
+            {
+            }
+
+            generator get_return_object() noexcept
+            {
+                return generator{handle_type::from_promise(*this)};
+            }
+
+            auto initial_suspend() noexcept
+            {
+                return detail::instrument_awaiter(*this, std::suspend_always{});
+            }
+
+            auto final_suspend() noexcept
+            {
+                return detail::instrument_awaiter(*this, FinalAwaiter{});
+            }
+
+            auto yield_value(yielded val) noexcept
+            {
+                root_->value_ = std::addressof(val);
+                return detail::instrument_awaiter(*this, std::suspend_always{});
+            }
+
+            auto yield_value(const std::remove_reference_t<yielded>& lvalue)
+                requires std::is_rvalue_reference_v<yielded>
+                    && std::constructible_from<std::remove_cvref_t<yielded>, const std::remove_reference_t<yielded>&>
+            {
+                struct CopyAwaiter
+                {
+                    std::remove_cvref_t<yielded> copy;
+                    promise_type& promise;
+
+                    bool await_ready() const noexcept
+                    {
+                        return false;
+                    }
+
+                    void await_suspend(std::coroutine_handle<>) noexcept
+                    {
+                        promise.root_->value_ = std::addressof(copy);
+                    }
+
+                    void await_resume() const noexcept
+                    {
+                    }
+                };
+
+                return detail::instrument_awaiter(*this, CopyAwaiter{lvalue, *this});
+            }
+
+            auto yield_value(elements_of<generator&&> nested) noexcept
+            {
+                return detail::instrument_awaiter(*this, NestedAwaiter<generator>{std::move(nested.range)});
+            }
+
+            auto yield_value(elements_of<generator&> nested) noexcept
+            {
+                return detail::instrument_awaiter(*this, NestedAwaiter<generator&>{nested.range});
+            }
+
+            template <std::ranges::input_range TRange>
+                requires std::convertible_to<std::ranges::range_reference_t<TRange>, yielded>
+            auto yield_value(elements_of<TRange> nested)
+            {
+                auto elements = [](std::ranges::iterator_t<TRange> it, std::ranges::sentinel_t<TRange> end) -> generator {
+                    for (; it != end; ++it)
+                        co_yield static_cast<yielded>(*it);
+                };
+
+                return detail::instrument_awaiter(*this,
+                    NestedAwaiter<generator>{elements(std::ranges::begin(nested.range), std::ranges::end(nested.range))});
+            }
+
+            template <typename TAwaitable>
+            TAwaitable&& await_transform(TAwaitable&&) = delete; // co_await is not allowed in generators
+
+            void return_void() const noexcept
+            {
+            }
+
+            void unhandled_exception()
+            {
+                exception_ = std::current_exception();
+            }
+
+            // resumes the innermost active generator (called on the root) - unless a stop was requested
+            void advance()
+            {
+                if (stop_token().stop_requested())
+                {
+                    cancelled_ = true;
+                    return;
+                }
+
+                active_.resume();
+            }
+
+            bool cancelled() const noexcept
+            {
+                return cancelled_;
+            }
+            reference current() const
+            {
+                return static_cast<reference>(*value_);
+            }
+
+            void rethrow_if_exception()
+            {
+                if (exception_)
+                    std::rethrow_exception(std::exchange(exception_, nullptr));
+            }
+        };
+
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = typename generator::value;
+            using reference = typename generator::reference;
+            using pointer = void;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            reference operator*() const
+            {
+                return coro_.promise().current();
+            }
+
+            iterator& operator++()
+            {
+                coro_.promise().advance();
+                coro_.promise().rethrow_if_exception();
+                return *this;
+            }
+
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept
+            {
+                return !it.coro_ || it.coro_.done() || it.coro_.promise().cancelled();
+            }
+
+            friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept
+            {
+                return lhs == std::default_sentinel && rhs == std::default_sentinel;
+            }
+
+        private:
+            handle_type coro_ = nullptr;
+
+            friend generator;
+
+            explicit iterator(handle_type coro) noexcept
+                : coro_{coro}
+            {
+            }
+        };
+
+        generator() = default;
+
+        generator(generator&& other) noexcept
+            : coro_{std::exchange(other.coro_, nullptr)}
+        {
+        }
+
+        generator& operator=(generator other) noexcept
+        {
+            std::swap(coro_, other.coro_);
+            return *this;
+        }
+
+        ~generator()
+        {
+            if (coro_)
+                coro_.destroy();
+        }
+
+        // the iteration ends at the next element when a stop is requested
+        generator& with_stop_token(std::stop_token stop_token) & noexcept
+        {
+            coro_.promise().set_stop_token(std::move(stop_token));
+            return *this;
+        }
+
+        generator with_stop_token(std::stop_token stop_token) && noexcept
+        {
+            coro_.promise().set_stop_token(std::move(stop_token));
+            return std::move(*this);
+        }
+
+        iterator begin()
+        {
+            coro_.promise().advance();
+            coro_.promise().rethrow_if_exception();
+            return iterator{coro_};
+        }
+
+        iterator end() const noexcept
+        {
+            return {};
+        }
+
+    private:
+        handle_type coro_ = nullptr;
+
+        explicit generator(handle_type coro) noexcept
+            : coro_{coro}
+        {
+        }
+    };
+}
+
+#endif //COROUTINES_GENERATOR_HPP
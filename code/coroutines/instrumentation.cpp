@@ -0,0 +1,114 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "generator.hpp"
+#include "instrumentation.hpp"
+#include "pipeline_stages.hpp"
+#include "static_thread_pool.hpp"
+#include "sync_wait.hpp"
+#include "task.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace coro;
+using namespace pipeline_stages;
+
+namespace
+{
+    task<int> hop(static_thread_pool& pool, int hops)
+    {
+        for (int i = 0; i < hops; ++i)
+            co_await pool.schedule();
+        co_return hops;
+    }
+
+    const CoroutineProfile* find_profile(const std::vector<CoroutineProfile>& profiles, const std::string& function)
+    {
+        auto it = std::find_if(profiles.begin(), profiles.end(), [&](const CoroutineProfile& p) { return p.function.find(function) != std::string::npos; });
+        return it != profiles.end() ? &*it : nullptr;
+    }
+}
+
+TEST_CASE("instrumentation")
+{
+    CoroutineProfiler::instance().reset();
+
+    static_thread_pool pool{2};
+
+    REQUIRE(sum_of_chain(10) == 600);
+    REQUIRE(sync_wait(hop(pool, 2)) == 2);
+
+    const std::vector<CoroutineProfile> profiles = CoroutineProfiler::instance().profiles();
+
+    std::ostringstream json;
+    CoroutineProfiler::instance().dump_json(json);
+
+    if constexpr (!instrumentation_enabled)
+    {
+        SECTION("disabled - promises carry no extra state & nothing is recorded")
+        {
+            REQUIRE(std::is_empty_v<PromiseInstrumentation>);
+
+            REQUIRE(profiles.empty());
+            REQUIRE(json.str() == "{\n  \"instrumentation\": false,\n  \"coroutines\": []\n}\n");
+        }
+    }
+    else
+    {
+        SECTION("every coroutine function has its own profile")
+        {
+            const std::pair<const char*, const char*> functions[] = {
+                {"numbers", "pipeline_stages.hpp"}, {"take_until", "pipeline_stages.hpp"}, {"multiply", "pipeline_stages.hpp"},
+                {"add(", "pipeline_stages.hpp"}, {"hop", "instrumentation.cpp"}};
+
+            for (const auto& [function, file] : functions)
+            {
+                CAPTURE(function);
+                const CoroutineProfile* profile = find_profile(profiles, function);
+
+                REQUIRE(profile != nullptr);
+                REQUIRE(profile->instances == 1);
+                REQUIRE(profile->frame_size > 0);
+                REQUIRE(profile->file.find(file) != std::string::npos);
+            }
+        }
+
+        SECTION("resumes - the first resume of a lazy coroutine and one per awaited suspension")
+        {
+            REQUIRE(find_profile(profiles, "numbers")->resumes == 11);
+            REQUIRE(find_profile(profiles, "take_until")->resumes == 11);
+            REQUIRE(find_profile(profiles, "multiply")->resumes == 11);
+            REQUIRE(find_profile(profiles, "hop")->resumes == 3);
+        }
+
+        SECTION("running & suspended time")
+        {
+            const CoroutineProfile* profile = find_profile(profiles, "multiply");
+
+            REQUIRE(profile->running.count() > 0);
+            REQUIRE(profile->suspended.count() > 0);
+        }
+
+        SECTION("JSON lists coroutines from the largest frame down")
+        {
+            REQUIRE(std::is_sorted(profiles.begin(), profiles.end(), [](const auto& a, const auto& b) { return a.frame_size > b.frame_size; }));
+            REQUIRE(json.str().find("\"frame_size\": ") != std::string::npos);
+            REQUIRE(json.str().find("multiply") != std::string::npos);
+        }
+    }
+}
+
+// build with -DCOROUTINES_INSTRUMENTATION=ON & run: coroutines "[profile]"
+TEST_CASE("instrumentation - profile of chain of generators", "[.][profile]")
+{
+    CoroutineProfiler::instance().reset();
+
+    REQUIRE(sum_of_chain(10'000) == 10 * (10'000LL * 9'999 / 2) + 15 * 10'000LL);
+
+    std::ofstream out{"coroutine_profile.json"};
+    CoroutineProfiler::instance().dump_json(out);
+}
@@ -0,0 +1,355 @@
+#ifndef COROUTINES_INSTRUMENTATION_HPP
+#define COROUTINES_INSTRUMENTATION_HPP
+
+//////////////////////////////////////////////////////////////////
+// COROUTINES_INSTRUMENTATION=1 (CMake option COROUTINES_INSTRUMENTATION) turns on profiling
+// of generator, task & eager_task coroutines - it must be the same in all translation units
+#ifndef COROUTINES_INSTRUMENTATION
+#define COROUTINES_INSTRUMENTATION 0
+#endif
+
+#include "awaitable_traits.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if COROUTINES_INSTRUMENTATION
+#include <source_location>
+#endif
+
+namespace coro
+{
+    inline constexpr bool instrumentation_enabled = COROUTINES_INSTRUMENTATION != 0;
+
+    //////////////////////////////////////////////////////////////////
+    // profile of all instances of a single coroutine function
+    //   * frame_size - size requested from the promise operator new (largest seen)
+    //   * resumes - resumptions after a suspension (the first resume of a lazy coroutine included)
+    //   * running - time between a (re)start and the next suspension
+    //   * suspended - time between a suspension and the next resumption
+    struct CoroutineProfile
+    {
+        std::string function;
+        std::string file;
+        std::uint32_t line{};
+        std::size_t frame_size{};
+        std::uint64_t instances{};
+        std::uint64_t resumes{};
+        std::chrono::nanoseconds running{};
+        std::chrono::nanoseconds suspended{};
+    };
+
+    namespace detail
+    {
+        struct ProfileCounters
+        {
+            std::string_view function;
+            std::string_view file;
+            std::uint32_t line;
+            std::atomic<std::size_t> frame_size{0};
+            std::atomic<std::uint64_t> instances{0};
+            std::atomic<std::uint64_t> resumes{0};
+            std::atomic<std::int64_t> running_ns{0};
+            std::atomic<std::int64_t> suspended_ns{0};
+
+            ProfileCounters(std::string_view function, std::string_view file, std::uint32_t line) noexcept
+                : function{function}
+                , file{file}
+                , line{line}
+            {
+            }
+        };
+
+        inline void write_json_string(std::ostream& out, std::string_view text)
+        {
+            out << '"';
+            for (char c : text)
+            {
+                if (c == '"' || c == '\\')
+                    out << '\\' << c;
+                else if (static_cast<unsigned char>(c) < 0x20)
+                    out << ' ';
+                else
+                    out << c;
+            }
+            out << '"';
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // CoroutineProfiler - process-wide registry of coroutine profiles
+    //   * a coroutine reports its counters when its frame is destroyed -
+    //     coroutines that are still alive are not included
+    //   * dump_json() lists coroutines from the largest frame down
+    class CoroutineProfiler
+    {
+        using Key = std::tuple<std::string_view, std::uint32_t, std::uint32_t>; // file, line, column
+
+        mutable std::mutex mtx_;
+        std::map<Key, detail::ProfileCounters> counters_; // nodes are stable - promises keep pointers to them
+
+    public:
+        static CoroutineProfiler& instance()
+        {
+            static CoroutineProfiler profiler;
+            return profiler;
+        }
+
+        detail::ProfileCounters& counters(std::string_view function, std::string_view file, std::uint32_t line, std::uint32_t column)
+        {
+            std::lock_guard lock{mtx_};
+            return counters_.try_emplace(Key{file, line, column}, function, file, line).first->second;
+        }
+
+        std::vector<CoroutineProfile> profiles() const
+        {
+            std::vector<CoroutineProfile> result;
+
+            std::lock_guard lock{mtx_};
+            for (const auto& [key, counters] : counters_)
+            {
+                if (counters.instances.load(std::memory_order_relaxed) == 0)
+                    continue;
+
+                result.push_back(CoroutineProfile{
+                    std::string{counters.function},
+                    std::string{counters.file},
+                    counters.line,
+                    counters.frame_size.load(std::memory_order_relaxed),
+                    counters.instances.load(std::memory_order_relaxed),
+                    counters.resumes.load(std::memory_order_relaxed),
+                    std::chrono::nanoseconds{counters.running_ns.load(std::memory_order_relaxed)},
+                    std::chrono::nanoseconds{counters.suspended_ns.load(std::memory_order_relaxed)}});
+            }
+
+            std::stable_sort(result.begin(), result.end(), [](const auto& a, const auto& b) { return a.frame_size > b.frame_size; });
+            return result;
+        }
+
+        void reset()
+        {
+            std::lock_guard lock{mtx_};
+            for (auto& [key, counters] : counters_)
+            {
+                counters.frame_size.store(0, std::memory_order_relaxed);
+                counters.instances.store(0, std::memory_order_relaxed);
+                counters.resumes.store(0, std::memory_order_relaxed);
+                counters.running_ns.store(0, std::memory_order_relaxed);
+                counters.suspended_ns.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        void dump_json(std::ostream& out) const
+        {
+            const std::vector<CoroutineProfile> all = profiles();
+
+            out << "{\n  \"instrumentation\": " << (instrumentation_enabled ? "true" : "false") << ",\n  \"coroutines\": [";
+
+            for (std::size_t i = 0; i < all.size(); ++i)
+            {
+                const CoroutineProfile& profile = all[i];
+
+                out << (i ? ",\n" : "\n") << "    {\"function\": ";
+                detail::write_json_string(out, profile.function);
+                out << ", \"file\": ";
+                detail::write_json_string(out, profile.file);
+                out << ", \"line\": " << profile.line
+                    << ", \"frame_size\": " << profile.frame_size
+                    << ", \"instances\": " << profile.instances
+                    << ", \"resumes\": " << profile.resumes
+                    << ", \"running_ns\": " << profile.running.count()
+                    << ", \"suspended_ns\": " << profile.suspended.count() << "}";
+            }
+
+            out << (all.empty() ? "]\n}\n" : "\n  ]\n}\n");
+        }
+    };
+
+#if COROUTINES_INSTRUMENTATION
+
+    namespace detail
+    {
+        using CoroutineLocation = std::source_location;
+
+        // size passed to the promise operator new - picked up by the promise constructor
+        // that runs right after the allocation on the same thread
+        inline std::size_t& last_frame_size() noexcept
+        {
+            thread_local std::size_t size = 0;
+            return size;
+        }
+
+        inline void record_frame_size(std::size_t frame_size) noexcept
+        {
+            last_frame_size() = frame_size;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // PromiseInstrumentation - base of instrumented promise types
+    //   * the promise constructor takes a CoroutineLocation defaulted to current() -
+    //     it is evaluated in the coroutine, so it names the coroutine function
+    //   * suspensions & resumptions are reported by awaiters wrapped with instrument_awaiter()
+    class PromiseInstrumentation
+    {
+        using Clock = std::chrono::steady_clock;
+
+        detail::ProfileCounters* counters_;
+        Clock::time_point last_transition_ = Clock::now();
+        Clock::duration running_{};
+        Clock::duration suspended_{};
+        std::uint64_t resumes_ = 0;
+        bool is_suspended_ = false;
+
+    public:
+        explicit PromiseInstrumentation(const detail::CoroutineLocation& location)
+            : counters_{&CoroutineProfiler::instance().counters(location.function_name(), location.file_name(), location.line(), location.column())}
+        {
+            const std::size_t frame_size = std::exchange(detail::last_frame_size(), 0);
+
+            std::size_t largest = counters_->frame_size.load(std::memory_order_relaxed);
+            while (frame_size > largest && !counters_->frame_size.compare_exchange_weak(largest, frame_size, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        PromiseInstrumentation(const PromiseInstrumentation&) = delete;
+        PromiseInstrumentation& operator=(const PromiseInstrumentation&) = delete;
+
+        ~PromiseInstrumentation()
+        {
+            if (!is_suspended_)
+                running_ += Clock::now() - last_transition_;
+
+            counters_->instances.fetch_add(1, std::memory_order_relaxed);
+            counters_->resumes.fetch_add(resumes_, std::memory_order_relaxed);
+            counters_->running_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(running_).count(), std::memory_order_relaxed);
+            counters_->suspended_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(suspended_).count(), std::memory_order_relaxed);
+        }
+
+        void on_suspend() noexcept
+        {
+            const auto now = Clock::now();
+            running_ += now - last_transition_;
+            last_transition_ = now;
+            is_suspended_ = true;
+        }
+
+        void on_resume() noexcept
+        {
+            if (!is_suspended_)
+                return; // await_ready() returned true - no suspension
+
+            const auto now = Clock::now();
+            suspended_ += now - last_transition_;
+            last_transition_ = now;
+            is_suspended_ = false;
+            ++resumes_;
+        }
+    };
+
+    namespace detail
+    {
+        // reports the suspension before the wrapped awaiter may hand the coroutine over
+        // to another thread - and the resumption in await_resume()
+        template <typename TAwaiter>
+        class InstrumentedAwaiter
+        {
+            TAwaiter awaiter_; // an awaiter or a reference to an awaiter passed to co_await
+            PromiseInstrumentation& instrumentation_;
+
+        public:
+            template <typename TArg>
+            InstrumentedAwaiter(TArg&& awaiter, PromiseInstrumentation& instrumentation)
+                : awaiter_(std::forward<TArg>(awaiter))
+                , instrumentation_{instrumentation}
+            {
+            }
+
+            bool await_ready() noexcept(noexcept(std::declval<TAwaiter&>().await_ready()))
+            {
+                return awaiter_.await_ready();
+            }
+
+            template <typename TPromise>
+            decltype(auto) await_suspend(std::coroutine_handle<TPromise> coro) noexcept(noexcept(std::declval<TAwaiter&>().await_suspend(coro)))
+            {
+                instrumentation_.on_suspend();
+                return awaiter_.await_suspend(coro);
+            }
+
+            decltype(auto) await_resume() noexcept(noexcept(std::declval<TAwaiter&>().await_resume()))
+            {
+                instrumentation_.on_resume();
+                return awaiter_.await_resume();
+            }
+        };
+
+        // for awaiters created by the promise (initial_suspend, yield_value, final_suspend)
+        template <typename TAwaiter>
+        auto instrument_awaiter(PromiseInstrumentation& instrumentation, TAwaiter awaiter) noexcept(std::is_nothrow_move_constructible_v<TAwaiter>)
+        {
+            return InstrumentedAwaiter<TAwaiter>{std::move(awaiter), instrumentation};
+        }
+
+        // for operands of co_await - promises declare await_transform() only when instrumented
+        template <typename TAwaitable>
+        auto instrument_awaitable(PromiseInstrumentation& instrumentation, TAwaitable&& awaitable)
+        {
+            using Awaiter = decltype(get_awaiter(std::forward<TAwaitable>(awaitable)));
+            return InstrumentedAwaiter<Awaiter>{get_awaiter(std::forward<TAwaitable>(awaitable)), instrumentation};
+        }
+    }
+
+#else
+
+    namespace detail
+    {
+        struct CoroutineLocation
+        {
+            static constexpr CoroutineLocation current() noexcept
+            {
+                return {};
+            }
+        };
+
+        inline void record_frame_size(std::size_t) noexcept
+        {
+        }
+    }
+
+    // instrumentation disabled - an empty base, awaiters are passed through untouched
+    class PromiseInstrumentation
+    {
+    public:
+        explicit constexpr PromiseInstrumentation(const detail::CoroutineLocation&) noexcept
+        {
+        }
+    };
+
+    namespace detail
+    {
+        template <typename TAwaiter>
+        TAwaiter instrument_awaiter(PromiseInstrumentation&, TAwaiter awaiter) noexcept(std::is_nothrow_move_constructible_v<TAwaiter>)
+        {
+            return awaiter;
+        }
+    }
+
+#endif
+}
+
+#endif //COROUTINES_INSTRUMENTATION_HPP
@@ -0,0 +1,217 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "generator.hpp"
+#include "pipeline.hpp"
+#include "spsc_ring.hpp"
+#include "static_thread_pool.hpp"
+#include "sync_wait.hpp"
+#include "task.hpp"
+#include "when_all.hpp"
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace coro;
+
+namespace
+{
+    generator<int> gen()
+    {
+        for (int i = 0;; ++i)
+            co_yield i;
+    }
+
+    long long sum_of_range(long long n)
+    {
+        return n * (n - 1) / 2;
+    }
+
+    constexpr auto plus = [](long long acc, auto value) { return acc + value; };
+
+    // simulates a CPU-bound step of a parse | transform | aggregate pipeline
+    std::uint64_t busy(std::uint64_t value, int rounds)
+    {
+        for (int i = 0; i < rounds; ++i)
+            value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+        return value;
+    }
+}
+
+TEST_CASE("SpscRing")
+{
+    static_thread_pool pool{2};
+
+    SECTION("values are popped in order")
+    {
+        SpscRing<std::string> ring{pool, 2};
+
+        auto test = [&]() -> task<std::vector<std::string>> {
+            co_await ring.push("a");
+            co_await ring.push("b");
+
+            std::vector<std::string> popped;
+            popped.push_back(*co_await ring.pop());
+            popped.push_back(*co_await ring.pop());
+            co_return popped;
+        };
+
+        REQUIRE(sync_wait(test()) == std::vector<std::string>{"a", "b"});
+    }
+
+    SECTION("producer & consumer on workers of the pool")
+    {
+        constexpr int items = 100'000;
+        SpscRing<int> ring{pool, 4};
+
+        auto producer = [&]() -> task<> {
+            co_await pool.schedule();
+            for (int i = 0; i < items; ++i)
+                co_await ring.push(i);
+            ring.close();
+        };
+
+        auto consumer = [&]() -> task<long long> {
+            co_await pool.schedule();
+            long long sum = 0;
+            while (auto value = co_await ring.pop())
+                sum += *value;
+            co_return sum;
+        };
+
+        auto [produced, sum] = sync_wait(when_all(producer(), consumer()));
+
+        REQUIRE(sum == sum_of_range(items));
+    }
+
+    SECTION("close by the consumer fails pushes")
+    {
+        SpscRing<int> ring{pool, 1};
+
+        auto test = [&]() -> task<std::tuple<bool, bool, std::optional<int>>> {
+            bool pushed = co_await ring.push(1);
+            ring.close();
+            bool pushed_after_close = co_await ring.push(2);
+            co_return std::tuple{pushed, pushed_after_close, co_await ring.pop()};
+        };
+
+        auto [pushed, pushed_after_close, last] = sync_wait(test());
+
+        REQUIRE(pushed);
+        REQUIRE_FALSE(pushed_after_close);
+        REQUIRE(last == 1);
+    }
+}
+
+TEST_CASE("pipeline")
+{
+    static_thread_pool pool{4};
+
+    const long long expected = 10 * sum_of_range(10'000) + 15 * 10'000LL;
+
+    SECTION("light stages are fused into one segment")
+    {
+        auto p = pipeline(gen())
+            | stages::take_while([](int x) { return x != 10'000; })
+            | stages::transform([](int x) { return x * 10; })
+            | stages::transform([](int x) { return x + 15; });
+
+        static_assert(decltype(p)::segments() == 1);
+
+        REQUIRE(sync_wait(std::move(p).run(pool, 0LL, plus)) == expected);
+    }
+
+    SECTION("every cpu_heavy stage starts a new segment")
+    {
+        auto p = pipeline(gen())
+            | stages::take_while([](int x) { return x != 10'000; })
+            | stages::transform([](int x) { return x * 10; }, stages::cpu_heavy)
+            | stages::transform([](int x) { return x + 15; }, stages::cpu_heavy);
+
+        static_assert(decltype(p)::segments() == 3);
+
+        const auto [batch_size, ring_capacity] = GENERATE(table<std::size_t, std::size_t>({{1, 1}, {7, 2}, {256, 8}}));
+        CAPTURE(batch_size, ring_capacity);
+
+        REQUIRE(sync_wait(std::move(p).run(pool, 0LL, plus, batch_size, ring_capacity)) == expected);
+    }
+
+    SECTION("take_while in a downstream segment stops the infinite source")
+    {
+        auto p = pipeline(gen())
+            | stages::transform([](int x) { return std::to_string(x); }, stages::cpu_heavy)
+            | stages::take_while([](const std::string& s) { return s != "1000"; })
+            | stages::filter([](const std::string& s) { return s.back() == '0'; }, stages::cpu_heavy);
+
+        auto count = sync_wait(std::move(p).run(pool, 0, [](int acc, const std::string&) { return acc + 1; }, 16, 2));
+
+        REQUIRE(count == 100);
+    }
+
+    SECTION("source range is borrowed")
+    {
+        std::vector<int> source{1, 2, 3, 4, 5, 6};
+
+        auto p = pipeline(source)
+            | stages::filter([](int x) { return x % 2 == 0; }, stages::cpu_heavy);
+
+        auto evens = sync_wait(std::move(p).run(pool, std::vector<int>{}, [](std::vector<int> acc, int x) {
+            acc.push_back(x);
+            return acc;
+        }, 2, 1));
+
+        REQUIRE(evens == std::vector{2, 4, 6});
+    }
+
+    SECTION("exception thrown in a stage is rethrown by the task")
+    {
+        auto p = pipeline(gen())
+            | stages::transform([](int x) {
+                  if (x == 5'000)
+                      throw std::runtime_error{"error in stage"};
+                  return x;
+              }, stages::cpu_heavy)
+            | stages::transform([](int x) { return x; }, stages::cpu_heavy);
+
+        REQUIRE_THROWS_AS(sync_wait(std::move(p).run(pool, 0LL, plus, 64, 2)), std::runtime_error);
+    }
+}
+
+TEST_CASE("pipeline - benchmarks", "[.][benchmark]")
+{
+    constexpr int items = 20'000;
+    constexpr int rounds = 2'000;
+    const auto thread_count = std::max(4u, std::thread::hardware_concurrency());
+    static_thread_pool pool{thread_count};
+
+    auto parse = [](int x) { return busy(x, rounds); };
+    auto transform = [](std::uint64_t x) { return busy(x, rounds); };
+    auto aggregate = [](std::uint64_t x) { return busy(x, rounds); };
+    auto below = [](int x) { return x < items; };
+    auto combine = [](std::uint64_t acc, std::uint64_t x) { return acc ^ x; };
+
+    BENCHMARK("parse | transform | aggregate - one segment")
+    {
+        auto p = pipeline(gen())
+            | stages::take_while(below)
+            | stages::transform(parse)
+            | stages::transform(transform)
+            | stages::transform(aggregate);
+
+        return sync_wait(std::move(p).run(pool, std::uint64_t{0}, combine));
+    };
+
+    BENCHMARK("parse | transform | aggregate - cpu_heavy stages on separate workers")
+    {
+        auto p = pipeline(gen())
+            | stages::take_while(below)
+            | stages::transform(parse)
+            | stages::transform(transform, stages::cpu_heavy)
+            | stages::transform(aggregate, stages::cpu_heavy);
+
+        return sync_wait(std::move(p).run(pool, std::uint64_t{0}, combine));
+    };
+}
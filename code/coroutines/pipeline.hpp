@@ -0,0 +1,373 @@
+#ifndef COROUTINES_PIPELINE_HPP
+#define COROUTINES_PIPELINE_HPP
+
+#include "spsc_ring.hpp"
+#include "static_thread_pool.hpp"
+#include "task.hpp"
+#include "when_all.hpp"
+
+#include <array>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace coro
+{
+    namespace stages
+    {
+        enum class Flow
+        {
+            proceed,
+            stop
+        };
+
+        // marks a stage that should run on its own worker
+        struct cpu_heavy_t
+        {
+            explicit cpu_heavy_t() = default;
+        };
+
+        inline constexpr cpu_heavy_t cpu_heavy{};
+
+        template <typename F, bool CpuHeavy>
+        struct Transform
+        {
+            F fn;
+
+            static constexpr bool is_cpu_heavy = CpuHeavy;
+
+            template <typename T>
+            using output_t = std::remove_cvref_t<std::invoke_result_t<F&, T&&>>;
+
+            template <typename T, typename Next>
+            Flow apply(T&& value, Next&& next)
+            {
+                return next(std::invoke(fn, std::forward<T>(value)));
+            }
+        };
+
+        template <typename Predicate, bool CpuHeavy>
+        struct Filter
+        {
+            Predicate pred;
+
+            static constexpr bool is_cpu_heavy = CpuHeavy;
+
+            template <typename T>
+            using output_t = T;
+
+            template <typename T, typename Next>
+            Flow apply(T&& value, Next&& next)
+            {
+                if (!std::invoke(pred, std::as_const(value)))
+                    return Flow::proceed;
+                return next(std::forward<T>(value));
+            }
+        };
+
+        template <typename Predicate, bool CpuHeavy>
+        struct TakeWhile
+        {
+            Predicate pred;
+
+            static constexpr bool is_cpu_heavy = CpuHeavy;
+
+            template <typename T>
+            using output_t = T;
+
+            template <typename T, typename Next>
+            Flow apply(T&& value, Next&& next)
+            {
+                if (!std::invoke(pred, std::as_const(value)))
+                    return Flow::stop;
+                return next(std::forward<T>(value));
+            }
+        };
+
+        template <typename F>
+        auto transform(F fn)
+        {
+            return Transform<F, false>{std::move(fn)};
+        }
+
+        template <typename F>
+        auto transform(F fn, cpu_heavy_t)
+        {
+            return Transform<F, true>{std::move(fn)};
+        }
+
+        template <typename Predicate>
+        auto filter(Predicate pred)
+        {
+            return Filter<Predicate, false>{std::move(pred)};
+        }
+
+        template <typename Predicate>
+        auto filter(Predicate pred, cpu_heavy_t)
+        {
+            return Filter<Predicate, true>{std::move(pred)};
+        }
+
+        template <typename Predicate>
+        auto take_while(Predicate pred)
+        {
+            return TakeWhile<Predicate, false>{std::move(pred)};
+        }
+
+        template <typename Predicate>
+        auto take_while(Predicate pred, cpu_heavy_t)
+        {
+            return TakeWhile<Predicate, true>{std::move(pred)};
+        }
+    }
+
+    template <typename TStage>
+    concept PipelineStage = requires {
+        { TStage::is_cpu_heavy } -> std::convertible_to<bool>;
+    };
+
+    namespace detail
+    {
+        template <typename T, typename TTuple>
+        struct PrependType;
+
+        template <typename T, typename... Ts>
+        struct PrependType<T, std::tuple<Ts...>>
+        {
+            using type = std::tuple<T, Ts...>;
+        };
+
+        // std::tuple<T, output of stage 0, output of stage 1, ...>
+        template <typename T, typename... TStages>
+        struct StageValueTypes
+        {
+            using type = std::tuple<T>;
+        };
+
+        template <typename T, typename TStage, typename... TRest>
+        struct StageValueTypes<T, TStage, TRest...>
+        {
+            using type = typename PrependType<T,
+                typename StageValueTypes<typename TStage::template output_t<T>, TRest...>::type>::type;
+        };
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // Pipeline - builder of a chain of stages running on a static_thread_pool
+    //   * pipeline(source) | stages::transform(f) | stages::filter(p, stages::cpu_heavy) | ...
+    //   * every stage marked cpu_heavy starts a new segment - a coroutine scheduled on the pool,
+    //     so segments run on different workers concurrently
+    //   * light stages are fused into the segment before them - no queue between them
+    //   * segments pass batches of values (std::vector) through SpscRing buffers
+    //   * run(pool, init, fold) folds the output of the last stage - the result is a task
+    //   * take_while stops the pipeline - upstream segments see their output ring closed
+    template <typename TSource, PipelineStage... TStages>
+    class Pipeline
+    {
+        template <typename, PipelineStage...>
+        friend class Pipeline;
+
+        using Flow = stages::Flow;
+        using ValueTypes = typename detail::StageValueTypes<std::ranges::range_value_t<TSource>, TStages...>::type;
+
+        // type of values after K stages
+        template <std::size_t K>
+        using value_type_at = std::tuple_element_t<K, ValueTypes>;
+
+        template <std::size_t K>
+        using Batch = std::vector<value_type_at<K>>;
+
+        static constexpr std::size_t stage_count = sizeof...(TStages);
+        static constexpr std::size_t segment_count = 1 + (std::size_t{TStages::is_cpu_heavy} + ... + 0);
+
+        // segment s consists of stages [boundaries[s], boundaries[s + 1]) - segment 0 also reads the source
+        static constexpr std::array<std::size_t, segment_count + 1> boundaries = [] {
+            constexpr std::array<bool, stage_count> heavy{TStages::is_cpu_heavy...};
+
+            std::array<std::size_t, segment_count + 1> result{};
+            std::size_t segment = 1;
+            for (std::size_t i = 0; i < stage_count; ++i)
+                if (heavy[i])
+                    result[segment++] = i;
+            result[segment_count] = stage_count;
+            return result;
+        }();
+
+        TSource source_;
+        std::tuple<TStages...> stages_;
+
+        template <std::size_t K, std::size_t End, typename T, typename Sink>
+        Flow process(T&& value, Sink& sink)
+        {
+            if constexpr (K == End)
+                return sink(std::forward<T>(value));
+            else
+                return std::get<K>(stages_).apply(std::forward<T>(value), [this, &sink](auto&& output) {
+                    return process<K + 1, End>(std::forward<decltype(output)>(output), sink);
+                });
+        }
+
+        template <std::size_t S, typename Rings, typename Acc, typename Fold>
+        task<> run_segment(static_thread_pool& pool, Rings& rings, Acc& acc, Fold& fold, std::size_t batch_size)
+        {
+            constexpr std::size_t first = boundaries[S];
+            constexpr std::size_t last = boundaries[S + 1];
+            constexpr bool is_first_segment = S == 0;
+            constexpr bool is_last_segment = S + 1 == segment_count;
+
+            co_await pool.schedule();
+
+            Batch<last> batch;
+            if constexpr (!is_last_segment)
+                batch.reserve(batch_size);
+
+            auto sink = [&](auto&& value) {
+                if constexpr (is_last_segment)
+                    acc = std::invoke(fold, std::move(acc), std::forward<decltype(value)>(value));
+                else
+                    batch.push_back(std::forward<decltype(value)>(value));
+                return Flow::proceed;
+            };
+
+            bool stopped = false;
+            std::exception_ptr error;
+
+            try
+            {
+                if constexpr (is_first_segment)
+                {
+                    for (auto&& item : source_)
+                    {
+                        if (process<first, last>(value_type_at<0>(std::forward<decltype(item)>(item)), sink) == Flow::stop)
+                            break;
+
+                        if constexpr (!is_last_segment)
+                        {
+                            if (batch.size() >= batch_size)
+                            {
+                                if (!co_await std::get<S>(rings)->push(std::exchange(batch, {})))
+                                    break; // downstream has stopped
+                                batch.reserve(batch_size);
+                            }
+                        }
+                    }
+                }
+                else
+                {
+                    while (!stopped)
+                    {
+                        auto input = co_await std::get<S - 1>(rings)->pop();
+                        if (!input)
+                            break;
+
+                        for (auto& item : *input)
+                        {
+                            if (process<first, last>(std::move(item), sink) == Flow::stop)
+                            {
+                                stopped = true;
+                                break;
+                            }
+
+                            if constexpr (!is_last_segment)
+                            {
+                                if (batch.size() >= batch_size)
+                                {
+                                    if (!co_await std::get<S>(rings)->push(std::exchange(batch, {})))
+                                    {
+                                        stopped = true;
+                                        break;
+                                    }
+                                    batch.reserve(batch_size);
+                                }
+                            }
+                        }
+                    }
+                }
+
+                if constexpr (!is_last_segment)
+                {
+                    if (!batch.empty())
+                        co_await std::get<S>(rings)->push(std::move(batch));
+                }
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            if constexpr (!is_first_segment)
+            {
+                if (stopped || error)
+                    std::get<S - 1>(rings)->close(); // pending & later pushes of the upstream segment fail
+            }
+
+            if constexpr (!is_last_segment)
+                std::get<S>(rings)->close();
+
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        template <typename Acc, typename Fold, std::size_t... Rs>
+        task<> run_segments(static_thread_pool& pool, Acc& acc, Fold& fold, std::size_t batch_size,
+            std::size_t ring_capacity, std::index_sequence<Rs...>)
+        {
+            // ring Rs connects segment Rs with segment Rs + 1
+            std::tuple<std::unique_ptr<SpscRing<Batch<boundaries[Rs + 1]>>>...> rings{
+                std::make_unique<SpscRing<Batch<boundaries[Rs + 1]>>>(pool, ring_capacity)...};
+
+            co_await when_all(
+                run_segment<0>(pool, rings, acc, fold, batch_size),
+                run_segment<Rs + 1>(pool, rings, acc, fold, batch_size)...);
+        }
+
+        template <typename Acc, typename Fold>
+        static task<Acc> run_pipeline(Pipeline self, static_thread_pool& pool, Acc acc, Fold fold,
+            std::size_t batch_size, std::size_t ring_capacity)
+        {
+            co_await self.run_segments(pool, acc, fold, batch_size, ring_capacity, std::make_index_sequence<segment_count - 1>{});
+            co_return acc;
+        }
+
+    public:
+        Pipeline(TSource source, std::tuple<TStages...> stages)
+            : source_{std::move(source)}
+            , stages_{std::move(stages)}
+        {
+        }
+
+        static constexpr std::size_t segments() noexcept
+        {
+            return segment_count;
+        }
+
+        template <PipelineStage TStage>
+        auto operator|(TStage stage) &&
+        {
+            return Pipeline<TSource, TStages..., TStage>{
+                std::move(source_), std::tuple_cat(std::move(stages_), std::tuple<TStage>{std::move(stage)})};
+        }
+
+        // lazy - the pipeline starts when the returned task is awaited
+        template <typename Acc, typename Fold>
+        task<Acc> run(static_thread_pool& pool, Acc init, Fold fold, std::size_t batch_size = 256, std::size_t ring_capacity = 8) &&
+        {
+            return run_pipeline(std::move(*this), pool, std::move(init), std::move(fold), batch_size, ring_capacity);
+        }
+    };
+
+    template <std::ranges::viewable_range TRange>
+    auto pipeline(TRange&& source)
+    {
+        using Source = std::views::all_t<TRange>;
+        return Pipeline<Source>{std::views::all(std::forward<TRange>(source)), std::tuple<>{}};
+    }
+}
+
+#endif //COROUTINES_PIPELINE_HPP
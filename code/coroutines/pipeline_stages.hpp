@@ -0,0 +1,52 @@
+#ifndef COROUTINES_PIPELINE_STAGES_HPP
+#define COROUTINES_PIPELINE_STAGES_HPP
+
+#include "generator.hpp"
+
+#include <numeric>
+
+//////////////////////////////////////////////////////////////////
+// numbers | take_until | multiply | add - the synchronous chain of generators shared by the tests
+//   * for sentinel 10 the chain yields 15, 25, ..., 105 - the sum is 600
+namespace pipeline_stages
+{
+    inline coro::generator<int> numbers()
+    {
+        for (int i = 0;; ++i)
+            co_yield i;
+    }
+
+    inline coro::generator<int> take_until(coro::generator<int>& g, int sentinel)
+    {
+        for (auto value : g)
+        {
+            if (value == sentinel)
+                break;
+            co_yield value;
+        }
+    }
+
+    inline coro::generator<int> multiply(coro::generator<int>& seq, int factor)
+    {
+        for (auto value : seq)
+            co_yield value * factor;
+    }
+
+    inline coro::generator<int> add(coro::generator<int>& seq, int offset)
+    {
+        for (auto value : seq)
+            co_yield value + offset;
+    }
+
+    inline long long sum_of_chain(int sentinel)
+    {
+        auto g = numbers();
+        auto t = take_until(g, sentinel);
+        auto m = multiply(t, 10);
+        auto a = add(m, 15);
+
+        return std::accumulate(a.begin(), a.end(), 0LL);
+    }
+}
+
+#endif //COROUTINES_PIPELINE_STAGES_HPP
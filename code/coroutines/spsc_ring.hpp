@@ -0,0 +1,296 @@
+#ifndef COROUTINES_SPSC_RING_HPP
+#define COROUTINES_SPSC_RING_HPP
+
+#include "static_thread_pool.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace coro
+{
+    //////////////////////////////////////////////////////////////////
+    // SpscRing<T> - bounded single-producer single-consumer ring with awaitable push & pop
+    //   * lock-free fast path: head and tail are written by one side only
+    //   * a side that has to wait publishes its operation - the other side completes it
+    //     (pushes the pending value / pops into the pending slot) and posts the waiter
+    //     to the thread pool, so each side keeps running on its own worker
+    //   * close() - pending and later pushes return false, pop returns std::nullopt once drained
+    template <typename T>
+    class SpscRing
+    {
+        static_assert(std::is_default_constructible_v<T> && std::is_nothrow_move_assignable_v<T>);
+
+        static constexpr std::size_t cache_line = 64;
+
+        std::vector<T> slots_;
+        std::size_t mask_;
+        static_thread_pool& pool_;
+
+        alignas(cache_line) std::atomic<std::size_t> head_{0}; // written by the consumer
+        alignas(cache_line) std::atomic<std::size_t> tail_{0}; // written by the producer
+        alignas(cache_line) std::atomic<bool> closed_{false};
+        std::atomic<void*> waiting_producer_{nullptr};
+        std::atomic<void*> waiting_consumer_{nullptr};
+        std::mutex mtx_; // taken only to publish or take over a waiting operation
+
+        bool try_push(T& value) noexcept
+        {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_.load(std::memory_order_acquire) == slots_.size())
+                return false;
+
+            slots_[tail & mask_] = std::move(value);
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_pop(std::optional<T>& value) noexcept
+        {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire))
+                return false;
+
+            value.emplace(std::move(slots_[head & mask_]));
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+    public:
+        class PushOperation
+        {
+            SpscRing& ring_;
+            T value_;
+            bool pushed_ = false;
+            std::coroutine_handle<> coro_;
+
+            friend SpscRing;
+
+        public:
+            PushOperation(SpscRing& ring, T&& value) noexcept
+                : ring_{ring}
+                , value_{std::move(value)}
+            {
+            }
+
+            bool await_ready()
+            {
+                if (ring_.closed_.load(std::memory_order_acquire))
+                    return true;
+
+                if (!ring_.try_push(value_))
+                    return false;
+
+                pushed_ = true;
+                ring_.complete_waiting_consumer();
+                return true;
+            }
+
+            bool await_suspend(std::coroutine_handle<> coro)
+            {
+                coro_ = coro;
+                return ring_.wait_to_push(*this);
+            }
+
+            // false - the ring was closed and the value was not pushed
+            bool await_resume() const noexcept
+            {
+                return pushed_;
+            }
+        };
+
+        class PopOperation
+        {
+            SpscRing& ring_;
+            std::optional<T> value_;
+            std::coroutine_handle<> coro_;
+
+            friend SpscRing;
+
+        public:
+            explicit PopOperation(SpscRing& ring) noexcept
+                : ring_{ring}
+            {
+            }
+
+            bool await_ready()
+            {
+                if (ring_.try_pop(value_))
+                {
+                    ring_.complete_waiting_producer();
+                    return true;
+                }
+
+                if (!ring_.closed_.load(std::memory_order_acquire))
+                    return false;
+
+                ring_.try_pop(value_); // a value pushed just before close()
+                return true;
+            }
+
+            bool await_suspend(std::coroutine_handle<> coro)
+            {
+                coro_ = coro;
+                return ring_.wait_to_pop(*this);
+            }
+
+            // std::nullopt - the ring is closed and empty
+            std::optional<T> await_resume() noexcept
+            {
+                return std::move(value_);
+            }
+        };
+
+        SpscRing(static_thread_pool& pool, std::size_t capacity)
+            : pool_{pool}
+        {
+            std::size_t size = 1;
+            while (size < capacity)
+                size *= 2;
+
+            slots_.resize(size);
+            mask_ = size - 1;
+        }
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        [[nodiscard]] PushOperation push(T value) noexcept
+        {
+            return PushOperation{*this, std::move(value)};
+        }
+
+        [[nodiscard]] PopOperation pop() noexcept
+        {
+            return PopOperation{*this};
+        }
+
+        // may be called by either side
+        void close()
+        {
+            closed_.store(true, std::memory_order_seq_cst);
+
+            PushOperation* producer;
+            PopOperation* consumer;
+
+            {
+                std::lock_guard lock{mtx_};
+                producer = static_cast<PushOperation*>(waiting_producer_.exchange(nullptr, std::memory_order_relaxed));
+                consumer = static_cast<PopOperation*>(waiting_consumer_.exchange(nullptr, std::memory_order_relaxed));
+            }
+
+            if (producer)
+                pool_.post(producer->coro_);
+
+            if (consumer)
+            {
+                try_pop(consumer->value_);
+                pool_.post(consumer->coro_);
+            }
+        }
+
+    private:
+        bool full() const noexcept
+        {
+            return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire) == slots_.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire);
+        }
+
+        // the waiter is published & re-checked under the lock - a waking side cannot
+        // take over the operation in between, and never sees a stale waiter
+        bool wait_to_push(PushOperation& op)
+        {
+            {
+                std::lock_guard lock{mtx_};
+
+                waiting_producer_.store(&op, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in complete_waiting_producer()
+
+                if (!closed_.load(std::memory_order_acquire) && full())
+                    return true; // the consumer completes the push
+
+                waiting_producer_.store(nullptr, std::memory_order_relaxed);
+            }
+
+            if (!closed_.load(std::memory_order_acquire))
+            {
+                op.pushed_ = try_push(op.value_);
+                complete_waiting_consumer();
+            }
+            return false;
+        }
+
+        bool wait_to_pop(PopOperation& op)
+        {
+            {
+                std::lock_guard lock{mtx_};
+
+                waiting_consumer_.store(&op, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in complete_waiting_consumer()
+
+                if (!closed_.load(std::memory_order_acquire) && empty())
+                    return true; // the producer completes the pop
+
+                waiting_consumer_.store(nullptr, std::memory_order_relaxed);
+            }
+
+            if (try_pop(op.value_))
+                complete_waiting_producer();
+            return false;
+        }
+
+        // after a push - the producer pops on behalf of the waiting consumer
+        void complete_waiting_consumer()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!waiting_consumer_.load(std::memory_order_relaxed))
+                return;
+
+            PopOperation* consumer = nullptr;
+            {
+                // the consumer may have drained the ring and started waiting again in the meantime
+                std::lock_guard lock{mtx_};
+                if (!empty())
+                    consumer = static_cast<PopOperation*>(waiting_consumer_.exchange(nullptr, std::memory_order_relaxed));
+            }
+
+            if (consumer)
+            {
+                try_pop(consumer->value_);
+                pool_.post(consumer->coro_);
+            }
+        }
+
+        // after a pop - the consumer pushes on behalf of the waiting producer
+        void complete_waiting_producer()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!waiting_producer_.load(std::memory_order_relaxed))
+                return;
+
+            PushOperation* producer = nullptr;
+            {
+                std::lock_guard lock{mtx_};
+                if (!full())
+                    producer = static_cast<PushOperation*>(waiting_producer_.exchange(nullptr, std::memory_order_relaxed));
+            }
+
+            if (producer)
+            {
+                producer->pushed_ = try_push(producer->value_);
+                pool_.post(producer->coro_);
+            }
+        }
+    };
+}
+
+#endif //COROUTINES_SPSC_RING_HPP
@@ -0,0 +1,181 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "static_thread_pool.hpp"
+#include "sync_wait.hpp"
+#include "task.hpp"
+#include "when_all.hpp"
+#include "work_stealing_deque.hpp"
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace coro;
+
+namespace
+{
+    long long fib(int n)
+    {
+        return n < 2 ? n : fib(n - 1) + fib(n - 2);
+    }
+
+    constexpr int sequential_threshold = 20;
+
+    task<long long> parallel_fib(static_thread_pool& pool, int n);
+
+    task<long long> fork_fib(static_thread_pool& pool, int n)
+    {
+        co_await pool.schedule();
+        co_return co_await parallel_fib(pool, n);
+    }
+
+    task<long long> parallel_fib(static_thread_pool& pool, int n)
+    {
+        if (n < sequential_threshold)
+            co_return fib(n);
+
+        auto [a, b] = co_await when_all(fork_fib(pool, n - 1), fork_fib(pool, n - 2));
+        co_return a + b;
+    }
+
+    long long async_fib(int n)
+    {
+        if (n < sequential_threshold)
+            return fib(n);
+
+        auto a = std::async(std::launch::async, async_fib, n - 1);
+        auto b = async_fib(n - 2);
+        return a.get() + b;
+    }
+}
+
+TEST_CASE("WorkStealingDeque")
+{
+    WorkStealingDeque<int*> deque{2};
+    std::vector<int> items(100);
+
+    SECTION("owner pops in LIFO order, thieves steal in FIFO order")
+    {
+        for (int& item : items)
+            deque.push(&item);
+
+        REQUIRE(deque.size() == 100);
+        REQUIRE(deque.pop() == &items[99]);
+        REQUIRE(deque.steal() == &items[0]);
+        REQUIRE(deque.steal() == &items[1]);
+        REQUIRE(deque.size() == 97);
+    }
+
+    SECTION("empty")
+    {
+        REQUIRE(deque.pop() == nullptr);
+        REQUIRE(deque.steal() == nullptr);
+    }
+
+    SECTION("each item is taken exactly once")
+    {
+        constexpr int count = 100'000;
+        WorkStealingDeque<std::intptr_t> numbers;
+        std::atomic<long long> stolen_sum{0};
+        std::atomic<bool> done{false};
+
+        std::vector<std::jthread> thieves;
+        for (int i = 0; i < 3; ++i)
+            thieves.emplace_back([&] {
+                long long sum = 0;
+                while (!done.load() || !numbers.empty())
+                {
+                    if (auto n = numbers.steal())
+                        sum += n;
+                }
+                stolen_sum += sum;
+            });
+
+        long long popped_sum = 0;
+        for (std::intptr_t n = 1; n <= count; ++n)
+        {
+            numbers.push(n);
+            if (n % 3 == 0)
+                popped_sum += numbers.pop();
+        }
+        while (auto n = numbers.pop())
+            popped_sum += n;
+
+        done = true;
+        thieves.clear();
+
+        REQUIRE(popped_sum + stolen_sum == count * (count + 1LL) / 2);
+    }
+}
+
+TEST_CASE("static_thread_pool")
+{
+    static_thread_pool pool{4};
+
+    SECTION("schedule moves the coroutine onto a worker")
+    {
+        auto on_pool = [&]() -> task<bool> {
+            co_await pool.schedule();
+            co_return pool.is_worker_thread();
+        };
+
+        REQUIRE_FALSE(pool.is_worker_thread());
+        REQUIRE(sync_wait(on_pool()));
+    }
+
+    SECTION("many scheduled tasks")
+    {
+        auto square = [&](int n) -> task<int> {
+            co_await pool.schedule();
+            co_return n * n;
+        };
+
+        std::vector<task<int>> tasks;
+        for (int i = 0; i < 1'000; ++i)
+            tasks.push_back(square(i));
+
+        auto squares = sync_wait(when_all(std::move(tasks)));
+
+        REQUIRE(std::accumulate(squares.begin(), squares.end(), 0LL) == 332'833'500);
+    }
+
+    SECTION("fork/join")
+    {
+        REQUIRE(sync_wait(parallel_fib(pool, 25)) == fib(25));
+    }
+}
+
+TEST_CASE("static_thread_pool - benchmarks", "[.][benchmark]")
+{
+    constexpr int n = 30;
+    const auto thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    BENCHMARK("fib(30) - sequential")
+    {
+        return fib(n);
+    };
+
+    {
+        static_thread_pool single{1};
+
+        BENCHMARK("fib(30) - static_thread_pool - 1 thread")
+        {
+            return sync_wait(parallel_fib(single, n));
+        };
+    }
+
+    {
+        static_thread_pool pool{thread_count};
+
+        BENCHMARK("fib(30) - static_thread_pool - hardware_concurrency threads")
+        {
+            return sync_wait(parallel_fib(pool, n));
+        };
+    }
+
+    BENCHMARK("fib(30) - std::async")
+    {
+        return async_fib(n);
+    };
+}
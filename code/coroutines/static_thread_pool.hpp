@@ -0,0 +1,223 @@
+#ifndef COROUTINES_STATIC_THREAD_POOL_HPP
+#define COROUTINES_STATIC_THREAD_POOL_HPP
+
+#include "work_stealing_deque.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace coro
+{
+    //////////////////////////////////////////////////////////////////
+    // static_thread_pool - fixed set of worker threads resuming coroutines
+    //   * co_await pool.schedule() moves the coroutine onto a worker
+    //   * a coroutine scheduled from a worker goes to the LIFO end of the worker's own
+    //     Chase-Lev deque - idle workers steal from the FIFO end of the other deques
+    //   * coroutines scheduled from other threads go through a shared injection queue
+    //   * idle workers sleep on an atomic epoch - no lock on the fast path
+    //   * coroutines still queued when the pool is destroyed are never resumed
+    class static_thread_pool
+    {
+        struct alignas(64) Worker
+        {
+            WorkStealingDeque<std::coroutine_handle<>> deque;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers_;
+
+        std::mutex injection_mtx_;
+        std::deque<std::coroutine_handle<>> injection_queue_;
+        std::atomic<std::size_t> injected_{0};
+
+        alignas(64) std::atomic<std::uint32_t> epoch_{0};
+        std::atomic<std::size_t> sleepers_{0};
+        std::atomic<bool> stop_{false};
+
+        std::vector<std::thread> threads_;
+
+        struct ThreadContext
+        {
+            static_thread_pool* pool = nullptr;
+            std::size_t index = 0;
+        };
+
+        static ThreadContext& this_thread_context() noexcept
+        {
+            thread_local ThreadContext context;
+            return context;
+        }
+
+        void wake_one() noexcept
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (sleepers_.load(std::memory_order_relaxed) > 0)
+            {
+                epoch_.fetch_add(1, std::memory_order_release);
+                epoch_.notify_one();
+            }
+        }
+
+        std::coroutine_handle<> pop_injected()
+        {
+            if (injected_.load(std::memory_order_relaxed) == 0)
+                return nullptr;
+
+            std::lock_guard lock{injection_mtx_};
+            if (injection_queue_.empty())
+                return nullptr;
+
+            std::coroutine_handle<> coro = injection_queue_.front();
+            injection_queue_.pop_front();
+            injected_.fetch_sub(1, std::memory_order_relaxed);
+            return coro;
+        }
+
+        std::coroutine_handle<> find_work(std::size_t index)
+        {
+            if (auto coro = workers_[index]->deque.pop())
+                return coro;
+
+            if (auto coro = pop_injected())
+                return coro;
+
+            for (std::size_t i = 1; i < workers_.size(); ++i)
+            {
+                if (auto coro = workers_[(index + i) % workers_.size()]->deque.steal())
+                    return coro;
+            }
+
+            return nullptr;
+        }
+
+        void run(std::size_t index)
+        {
+            this_thread_context() = ThreadContext{this, index};
+
+            while (true)
+            {
+                if (auto coro = find_work(index))
+                {
+                    coro.resume();
+                    continue;
+                }
+
+                const std::uint32_t seen_epoch = epoch_.load(std::memory_order_acquire);
+                sleepers_.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in wake_one()
+
+                if (auto coro = find_work(index))
+                {
+                    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                    coro.resume();
+                    continue;
+                }
+
+                if (stop_.load(std::memory_order_acquire))
+                {
+                    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                    return;
+                }
+
+                epoch_.wait(seen_epoch, std::memory_order_acquire);
+                sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        void enqueue(std::coroutine_handle<> coro)
+        {
+            ThreadContext& context = this_thread_context();
+
+            if (context.pool == this)
+                workers_[context.index]->deque.push(coro);
+            else
+            {
+                std::lock_guard lock{injection_mtx_};
+                injection_queue_.push_back(coro);
+                injected_.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            wake_one();
+        }
+
+    public:
+        explicit static_thread_pool(std::size_t thread_count = std::max(1u, std::thread::hardware_concurrency()))
+        {
+            for (std::size_t i = 0; i < thread_count; ++i)
+                workers_.push_back(std::make_unique<Worker>());
+
+            for (std::size_t i = 0; i < thread_count; ++i)
+                threads_.emplace_back([this, i] { run(i); });
+        }
+
+        static_thread_pool(const static_thread_pool&) = delete;
+        static_thread_pool& operator=(const static_thread_pool&) = delete;
+
+        ~static_thread_pool()
+        {
+            stop_.store(true, std::memory_order_seq_cst);
+            epoch_.fetch_add(1, std::memory_order_release);
+            epoch_.notify_all();
+
+            for (std::thread& thd : threads_)
+                thd.join();
+        }
+
+        std::size_t thread_count() const noexcept
+        {
+            return threads_.size();
+        }
+
+        // true if called from one of the workers of this pool
+        bool is_worker_thread() const noexcept
+        {
+            return this_thread_context().pool == this;
+        }
+
+        class ScheduleOperation
+        {
+            static_thread_pool& pool_;
+
+        public:
+            explicit ScheduleOperation(static_thread_pool& pool) noexcept
+                : pool_{pool}
+            {
+            }
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> coro)
+            {
+                pool_.enqueue(coro);
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+        [[nodiscard]] ScheduleOperation schedule() noexcept
+        {
+            return ScheduleOperation{*this};
+        }
+
+        // resumes a suspended coroutine on a worker - for awaitables completed by other coroutines
+        void post(std::coroutine_handle<> coro)
+        {
+            enqueue(coro);
+        }
+    };
+}
+
+#endif //COROUTINES_STATIC_THREAD_POOL_HPP
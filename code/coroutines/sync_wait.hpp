@@ -0,0 +1,130 @@
+#ifndef COROUTINES_SYNC_WAIT_HPP
+#define COROUTINES_SYNC_WAIT_HPP
+
+#include "awaitable_traits.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <semaphore>
+#include <type_traits>
+#include <utility>
+
+namespace coro
+{
+    namespace detail
+    {
+        // coroutine that signals a semaphore when the awaited operation completes
+        class SyncWaitTask
+        {
+        public:
+            struct promise_type
+            {
+                std::binary_semaphore completed{0};
+                std::exception_ptr exception;
+
+                SyncWaitTask get_return_object() noexcept
+                {
+                    return SyncWaitTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+                }
+
+                std::suspend_always initial_suspend() const noexcept
+                {
+                    return {};
+                }
+
+                auto final_suspend() const noexcept
+                {
+                    struct Signal
+                    {
+                        bool await_ready() const noexcept
+                        {
+                            return false;
+                        }
+
+                        void await_suspend(std::coroutine_handle<promise_type> coro) const noexcept
+                        {
+                            coro.promise().completed.release();
+                        }
+
+                        void await_resume() const noexcept
+                        {
+                        }
+                    };
+
+                    return Signal{};
+                }
+
+                void return_void() const noexcept
+                {
+                }
+
+                void unhandled_exception() noexcept
+                {
+                    exception = std::current_exception();
+                }
+            };
+
+            explicit SyncWaitTask(std::coroutine_handle<promise_type> coro) noexcept
+                : coro_{coro}
+            {
+            }
+
+            SyncWaitTask(SyncWaitTask&& other) noexcept
+                : coro_{std::exchange(other.coro_, nullptr)}
+            {
+            }
+
+            ~SyncWaitTask()
+            {
+                if (coro_)
+                    coro_.destroy();
+            }
+
+            void run_and_wait()
+            {
+                coro_.resume();
+                coro_.promise().completed.acquire();
+
+                if (coro_.promise().exception)
+                    std::rethrow_exception(coro_.promise().exception);
+            }
+
+        private:
+            std::coroutine_handle<promise_type> coro_;
+        };
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // sync_wait - blocks the calling thread until the awaitable completes
+    //   * the awaitable may complete on another thread
+    //   * an exception from the awaitable is rethrown
+    template <typename TAwaitable>
+    auto sync_wait(TAwaitable&& awaitable)
+    {
+        using Result = await_result_t<TAwaitable>;
+
+        if constexpr (std::is_void_v<Result>)
+        {
+            auto wait = [](TAwaitable&& awaitable) -> detail::SyncWaitTask {
+                co_await std::forward<TAwaitable>(awaitable);
+            };
+
+            wait(std::forward<TAwaitable>(awaitable)).run_and_wait();
+        }
+        else
+        {
+            std::optional<std::remove_cvref_t<Result>> result;
+
+            auto wait = [](TAwaitable&& awaitable, auto& result) -> detail::SyncWaitTask {
+                result.emplace(co_await std::forward<TAwaitable>(awaitable));
+            };
+
+            wait(std::forward<TAwaitable>(awaitable), result).run_and_wait();
+
+            return std::move(*result);
+        }
+    }
+}
+
+#endif //COROUTINES_SYNC_WAIT_HPP
@@ -0,0 +1,251 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "async_file_reader.hpp"
+#include "sync_wait.hpp"
+#include "task.hpp"
+#include "when_all.hpp"
+#include "when_any.hpp"
+#include <chrono>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace coro;
+using namespace std::literals;
+
+namespace
+{
+    // resumes the awaiting coroutine on a thread of the pool
+    struct ResumeOn
+    {
+        BlockingThreadPool& pool;
+        std::chrono::milliseconds delay{0};
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> coro)
+        {
+            pool.submit([coro, delay = delay] {
+                std::this_thread::sleep_for(delay);
+                coro.resume();
+            });
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    task<int> value(int n)
+    {
+        co_return n;
+    }
+
+    eager_task<int> eager_value(int n)
+    {
+        co_return n;
+    }
+
+    task<long long> nested(int depth)
+    {
+        if (depth == 0)
+            co_return 0;
+        co_return 1 + co_await nested(depth - 1);
+    }
+
+    task<std::string> handle_request(BlockingThreadPool& pool, std::string request, std::chrono::milliseconds latency)
+    {
+        co_await ResumeOn{pool, latency};
+        co_return "response:" + request;
+    }
+}
+
+TEST_CASE("task")
+{
+    SECTION("is lazy")
+    {
+        bool started = false;
+        auto start = [&]() -> task<> {
+            started = true;
+            co_return;
+        };
+
+        auto t = start();
+
+        REQUIRE_FALSE(started);
+        sync_wait(t);
+        REQUIRE(started);
+        REQUIRE(t.is_ready());
+    }
+
+    SECTION("result")
+    {
+        REQUIRE(sync_wait(value(42)) == 42);
+    }
+
+    SECTION("exceptions")
+    {
+        auto failing = []() -> task<> {
+            throw std::runtime_error{"error"};
+            co_return;
+        };
+
+        REQUIRE_THROWS_AS(sync_wait(failing()), std::runtime_error);
+    }
+
+    SECTION("empty task")
+    {
+        task<int> moved = value(1);
+        task<int> t = std::move(moved);
+
+        REQUIRE_THROWS_AS(sync_wait(moved), std::logic_error);
+        REQUIRE_THROWS_AS(sync_wait(task<>{}), std::logic_error);
+        REQUIRE_THROWS_AS(moved.with_stop_token(std::stop_token{}), std::logic_error);
+        REQUIRE(sync_wait(t) == 1);
+    }
+
+    SECTION("continuation chaining")
+    {
+        REQUIRE(sync_wait(nested(10'000)) == 10'000);
+    }
+
+    SECTION("resumed on another thread")
+    {
+        BlockingThreadPool pool{1};
+        REQUIRE(sync_wait(handle_request(pool, "a", 0ms)) == "response:a");
+    }
+}
+
+TEST_CASE("eager_task")
+{
+    SECTION("starts at the call")
+    {
+        bool started = false;
+        auto start = [&]() -> eager_task<int> {
+            started = true;
+            co_return 1;
+        };
+
+        auto t = start();
+
+        REQUIRE(started);
+        REQUIRE(t.is_ready());
+        REQUIRE(sync_wait(t) == 1);
+    }
+
+    SECTION("completes on another thread")
+    {
+        BlockingThreadPool pool{1};
+        auto delayed = [&]() -> eager_task<int> {
+            co_await ResumeOn{pool, 5ms};
+            co_return 42;
+        };
+
+        auto t = delayed();
+
+        REQUIRE(sync_wait(t) == 42);
+    }
+
+    SECTION("exceptions")
+    {
+        auto t = []() -> eager_task<> {
+            throw std::runtime_error{"error"};
+            co_return;
+        }();
+
+        REQUIRE_THROWS_AS(sync_wait(t), std::runtime_error);
+    }
+
+    SECTION("empty task")
+    {
+        REQUIRE_THROWS_AS(sync_wait(eager_task<int>{}), std::logic_error);
+    }
+}
+
+TEST_CASE("when_all")
+{
+    BlockingThreadPool pool{4};
+
+    SECTION("heterogeneous results")
+    {
+        auto [a, b, c] = sync_wait(when_all(value(1), handle_request(pool, "b", 1ms), []() -> task<> { co_return; }()));
+
+        REQUIRE(a == 1);
+        REQUIRE(b == "response:b");
+        REQUIRE(c == std::monostate{});
+    }
+
+    SECTION("requests handled concurrently")
+    {
+        std::vector<task<std::string>> requests;
+        for (int i = 0; i < 4; ++i)
+            requests.push_back(handle_request(pool, std::to_string(i), 50ms));
+
+        auto start = std::chrono::steady_clock::now();
+        auto responses = sync_wait(when_all(std::move(requests)));
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        REQUIRE(responses == std::vector<std::string>{"response:0", "response:1", "response:2", "response:3"});
+        REQUIRE(elapsed < 150ms);
+    }
+
+    SECTION("exception is rethrown after all children complete")
+    {
+        auto failing = [&]() -> task<int> {
+            co_await ResumeOn{pool};
+            throw std::runtime_error{"error"};
+        };
+
+        REQUIRE_THROWS_AS(sync_wait(when_all(failing(), handle_request(pool, "b", 10ms))), std::runtime_error);
+    }
+
+    SECTION("empty vector")
+    {
+        REQUIRE(sync_wait(when_all(std::vector<task<int>>{})).empty());
+    }
+}
+
+TEST_CASE("when_any")
+{
+    BlockingThreadPool pool{4};
+
+    std::vector<task<std::string>> requests;
+    requests.push_back(handle_request(pool, "slow", 200ms));
+    requests.push_back(handle_request(pool, "fast", 1ms));
+
+    auto [index, response] = sync_wait(when_any(std::move(requests)));
+
+    REQUIRE(index == 1);
+    REQUIRE(response == "response:fast");
+}
+
+TEST_CASE("task - benchmarks", "[.][benchmark]")
+{
+    auto await_n = [](auto make_task, int n) -> task<long long> {
+        long long sum = 0;
+        for (int i = 0; i < n; ++i)
+            sum += co_await make_task(i);
+        co_return sum;
+    };
+
+    BENCHMARK("co_await ready eager_task x 1'000")
+    {
+        return sync_wait(await_n(eager_value, 1'000));
+    };
+
+    BENCHMARK("co_await lazy task x 1'000")
+    {
+        return sync_wait(await_n(value, 1'000));
+    };
+
+    BENCHMARK("chain of 1'000'000 nested tasks")
+    {
+        return sync_wait(nested(1'000'000));
+    };
+}
@@ -0,0 +1,422 @@
+#ifndef COROUTINES_TASK_HPP
+#define COROUTINES_TASK_HPP
+
+#include "cancellation.hpp"
+#include "frame_allocator.hpp"
+#include "instrumentation.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <stdexcept>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace coro
+{
+    template <typename T = void>
+    class task;
+
+    namespace detail
+    {
+        // awaiting a default-constructed or moved-from task is a logic error
+        [[noreturn]] inline void throw_empty_task()
+        {
+            throw std::logic_error{"empty task - default-constructed or moved-from"};
+        }
+
+        template <typename T>
+        class TaskResult
+        {
+            std::variant<std::monostate, T, std::exception_ptr> result_;
+
+        public:
+            template <typename U = T>
+                requires std::convertible_to<U&&, T>
+            void return_value(U&& value)
+            {
+                result_.template emplace<1>(std::forward<U>(value));
+            }
+
+            void unhandled_exception() noexcept
+            {
+                result_.template emplace<2>(std::current_exception());
+            }
+
+            void cancel() noexcept
+            {
+                result_.template emplace<2>(std::make_exception_ptr(operation_cancelled{}));
+            }
+
+            T& result() &
+            {
+                if (result_.index() == 2)
+                    std::rethrow_exception(std::get<2>(result_));
+                return std::get<1>(result_);
+            }
+
+            T&& result() &&
+            {
+                return std::move(result());
+            }
+        };
+
+        template <>
+        class TaskResult<void>
+        {
+            std::exception_ptr exception_;
+
+        public:
+            void return_void() noexcept
+            {
+            }
+
+            void unhandled_exception() noexcept
+            {
+                exception_ = std::current_exception();
+            }
+
+            void cancel() noexcept
+            {
+                exception_ = std::make_exception_ptr(operation_cancelled{});
+            }
+
+            void result()
+            {
+                if (exception_)
+                    std::rethrow_exception(exception_);
+            }
+        };
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // task<T> - lazy asynchronous computation
+    //   * the body starts when the task is co_awaited
+    //   * on completion the awaiting coroutine is resumed by symmetric transfer
+    //     (no stack growth in long chains of tasks)
+    //   * cancellable - see with_stop_token() & cancellation.hpp
+    //   * co_await & with_stop_token() on an empty task throw std::logic_error
+    template <typename T>
+    class task
+    {
+    public:
+        class promise_type : public FrameAllocation, public PromiseInstrumentation, public detail::TaskResult<T>, public detail::Cancellable
+        {
+            std::coroutine_handle<> continuation_ = std::noop_coroutine();
+
+            friend task;
+
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> finished) noexcept
+                {
+                    return finished.promise().continuation_;
+                }
+
+                void await_resume() const noexcept
+                {
+                }
+            };
+
+        public:
+            promise_type(detail::CoroutineLocation location = detail::CoroutineLocation::current())
+                : PromiseInstrumentation{location}
+            {
+            }
+
+            task get_return_object() noexcept
+            {
+                return task{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            auto initial_suspend() noexcept
+            {
+                return detail::instrument_awaiter(*this, std::suspend_always{});
+            }
+
+            auto final_suspend() noexcept
+            {
+                return detail::instrument_awaiter(*this, FinalAwaiter{});
+            }
+
+#if COROUTINES_INSTRUMENTATION
+            template <typename TAwaitable>
+            auto await_transform(TAwaitable&& awaitable)
+            {
+                return detail::instrument_awaitable(*this, std::forward<TAwaitable>(awaitable));
+            }
+#endif
+        };
+
+    private:
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        handle_type coro_ = nullptr;
+
+        explicit task(handle_type coro) noexcept
+            : coro_{coro}
+        {
+        }
+
+        struct AwaiterBase
+        {
+            handle_type coro;
+
+            bool await_ready() const
+            {
+                if (!coro)
+                    detail::throw_empty_task();
+                return coro.done();
+            }
+
+            template <typename TPromise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> awaiting) noexcept
+            {
+                promise_type& promise = coro.promise();
+                promise.inherit_stop_token(awaiting);
+
+                if (promise.stop_token().stop_requested())
+                {
+                    promise.cancel(); // the body never runs
+                    return awaiting;
+                }
+
+                promise.continuation_ = awaiting;
+                return coro;
+            }
+        };
+
+    public:
+        task() = default;
+
+        task(task&& other) noexcept
+            : coro_{std::exchange(other.coro_, nullptr)}
+        {
+        }
+
+        task& operator=(task other) noexcept
+        {
+            std::swap(coro_, other.coro_);
+            return *this;
+        }
+
+        ~task()
+        {
+            if (coro_)
+                coro_.destroy();
+        }
+
+        bool is_ready() const noexcept
+        {
+            return !coro_ || coro_.done();
+        }
+
+        // the task & all tasks it awaits are cancelled when a stop is requested
+        task& with_stop_token(std::stop_token stop_token) &
+        {
+            if (!coro_)
+                detail::throw_empty_task();
+            coro_.promise().set_stop_token(std::move(stop_token));
+            return *this;
+        }
+
+        task with_stop_token(std::stop_token stop_token) &&
+        {
+            if (!coro_)
+                detail::throw_empty_task();
+            coro_.promise().set_stop_token(std::move(stop_token));
+            return std::move(*this);
+        }
+
+        auto operator co_await() & noexcept
+        {
+            struct Awaiter : AwaiterBase
+            {
+                decltype(auto) await_resume()
+                {
+                    return this->coro.promise().result();
+                }
+            };
+
+            return Awaiter{coro_};
+        }
+
+        auto operator co_await() && noexcept
+        {
+            struct Awaiter : AwaiterBase
+            {
+                decltype(auto) await_resume()
+                {
+                    return std::move(this->coro.promise()).result();
+                }
+            };
+
+            return Awaiter{coro_};
+        }
+    };
+
+    //////////////////////////////////////////////////////////////////
+    // eager_task<T> - asynchronous computation started at the call
+    //   * the body runs until its first suspension before the caller gets the task
+    //   * may complete on another thread while it is being awaited - the continuation
+    //     is handed over with a single atomic exchange
+    //   * awaiting an already completed eager_task does not suspend
+    //   * awaiting an empty eager_task throws std::logic_error
+    template <typename T = void>
+    class eager_task
+    {
+    public:
+        class promise_type : public FrameAllocation, public PromiseInstrumentation, public detail::TaskResult<T>
+        {
+            // nullptr - running, this - completed, otherwise the address of the awaiting coroutine
+            std::atomic<void*> state_ = nullptr;
+
+            friend eager_task;
+
+            void* completed_state() noexcept
+            {
+                return this;
+            }
+
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> finished) noexcept
+                {
+                    promise_type& promise = finished.promise();
+                    void* awaiting = promise.state_.exchange(promise.completed_state(), std::memory_order_acq_rel);
+
+                    if (awaiting)
+                        return std::coroutine_handle<>::from_address(awaiting);
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept
+                {
+                }
+            };
+
+        public:
+            promise_type(detail::CoroutineLocation location = detail::CoroutineLocation::current())
+                : PromiseInstrumentation{location}
+            {
+            }
+
+            eager_task get_return_object() noexcept
+            {
+                return eager_task{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            auto initial_suspend() noexcept
+            {
+                return detail::instrument_awaiter(*this, std::suspend_never{});
+            }
+
+            auto final_suspend() noexcept
+            {
+                return detail::instrument_awaiter(*this, FinalAwaiter{});
+            }
+
+#if COROUTINES_INSTRUMENTATION
+            template <typename TAwaitable>
+            auto await_transform(TAwaitable&& awaitable)
+            {
+                return detail::instrument_awaitable(*this, std::forward<TAwaitable>(awaitable));
+            }
+#endif
+        };
+
+    private:
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        handle_type coro_ = nullptr;
+
+        explicit eager_task(handle_type coro) noexcept
+            : coro_{coro}
+        {
+        }
+
+        struct AwaiterBase
+        {
+            handle_type coro;
+
+            bool await_ready() const
+            {
+                if (!coro)
+                    detail::throw_empty_task();
+                return coro.promise().state_.load(std::memory_order_acquire) == coro.promise().completed_state();
+            }
+
+            bool await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                void* expected = nullptr;
+                return coro.promise().state_.compare_exchange_strong(expected, awaiting.address(), std::memory_order_acq_rel);
+            }
+        };
+
+    public:
+        eager_task() = default;
+
+        eager_task(eager_task&& other) noexcept
+            : coro_{std::exchange(other.coro_, nullptr)}
+        {
+        }
+
+        eager_task& operator=(eager_task other) noexcept
+        {
+            std::swap(coro_, other.coro_);
+            return *this;
+        }
+
+        // the task must be completed (or awaited to completion) before it is destroyed
+        ~eager_task()
+        {
+            if (coro_)
+                coro_.destroy();
+        }
+
+        bool is_ready() const noexcept
+        {
+            return !coro_ || coro_.promise().state_.load(std::memory_order_acquire) == coro_.promise().completed_state();
+        }
+
+        auto operator co_await() & noexcept
+        {
+            struct Awaiter : AwaiterBase
+            {
+                decltype(auto) await_resume()
+                {
+                    return this->coro.promise().result();
+                }
+            };
+
+            return Awaiter{coro_};
+        }
+
+        auto operator co_await() && noexcept
+        {
+            struct Awaiter : AwaiterBase
+            {
+                decltype(auto) await_resume()
+                {
+                    return std::move(this->coro.promise()).result();
+                }
+            };
+
+            return Awaiter{coro_};
+        }
+    };
+}
+
+#endif //COROUTINES_TASK_HPP
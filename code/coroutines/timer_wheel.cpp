@@ -0,0 +1,321 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "static_thread_pool.hpp"
+#include "sync_wait.hpp"
+#include "task.hpp"
+#include "timer_wheel.hpp"
+#include "when_all.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <stop_token>
+#include <vector>
+
+using namespace coro;
+using namespace std::chrono_literals;
+
+namespace
+{
+    task<int> sleeper(TimerWheel& timers, std::chrono::milliseconds duration, std::mutex& mtx, std::vector<int>& log)
+    {
+        co_await timers.sleep_for(duration);
+
+        std::lock_guard lock{mtx};
+        log.push_back(static_cast<int>(duration.count()));
+        co_return static_cast<int>(duration.count());
+    }
+
+    task<bool> sleep(TimerWheel& timers, std::chrono::milliseconds duration, std::stop_token stop_token = {})
+    {
+        co_return co_await timers.sleep_for(duration, std::move(stop_token));
+    }
+
+    task<std::size_t> sleep_many(TimerWheel& timers, std::size_t count, int max_ms)
+    {
+        std::mt19937 rnd{42};
+        std::uniform_int_distribution<int> distr{1, max_ms};
+
+        std::vector<task<bool>> sleepers;
+        sleepers.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            sleepers.push_back(sleep(timers, std::chrono::milliseconds{distr(rnd)}));
+
+        auto elapsed = co_await when_all(std::move(sleepers));
+        co_return std::count(elapsed.begin(), elapsed.end(), true);
+    }
+}
+
+TEST_CASE("HierarchicalTimerWheel")
+{
+    using detail::TimerLink;
+    using detail::TimerNode;
+
+    detail::HierarchicalTimerWheel wheel;
+
+    std::mt19937_64 rnd{665};
+    std::uniform_int_distribution<std::uint64_t> distr{0, 300'000};
+
+    std::vector<std::uint64_t> expiries = {0, 1, 63, 64, 65, 100, 4'095, 4'096, 4'097, 262'143, 262'144};
+    for (int i = 0; i < 1'000; ++i)
+        expiries.push_back(distr(rnd));
+
+    std::vector<std::unique_ptr<TimerNode>> nodes;
+    for (std::uint64_t expiry : expiries)
+    {
+        nodes.push_back(std::make_unique<TimerNode>());
+        nodes.back()->expiry = expiry;
+        wheel.insert(nodes.back().get());
+    }
+
+    REQUIRE(wheel.size() == expiries.size());
+
+    SECTION("every timer expires exactly at its tick")
+    {
+        for (std::uint64_t tick = 0; wheel.size() > 0; ++tick)
+        {
+            TimerLink expired;
+            wheel.advance(tick, expired);
+
+            while (!expired.empty())
+            {
+                auto* node = static_cast<TimerNode*>(expired.next);
+                node->unlink();
+                REQUIRE(node->expiry == tick);
+                REQUIRE(node->state == TimerNode::State::ready);
+            }
+        }
+    }
+
+    SECTION("advancing by many ticks at once never expires a timer early")
+    {
+        std::size_t expired_count = 0;
+
+        for (std::uint64_t now = 0; wheel.size() > 0; now += 997)
+        {
+            TimerLink expired;
+            wheel.advance(now, expired);
+
+            while (!expired.empty())
+            {
+                auto* node = static_cast<TimerNode*>(expired.next);
+                node->unlink();
+                REQUIRE(node->expiry <= now);
+                REQUIRE(node->expiry + 997 > now);
+                ++expired_count;
+            }
+        }
+
+        REQUIRE(expired_count == expiries.size());
+    }
+
+    SECTION("removed timers never expire")
+    {
+        for (std::size_t i = 0; i < nodes.size(); i += 2)
+            wheel.remove(nodes[i].get());
+
+        std::size_t expired_count = 0;
+
+        TimerLink expired;
+        wheel.advance(1'000'000, expired);
+        while (!expired.empty())
+        {
+            auto* node = static_cast<TimerNode*>(expired.next);
+            node->unlink();
+            REQUIRE(node != nodes[0].get());
+            ++expired_count;
+        }
+
+        REQUIRE(expired_count == nodes.size() / 2);
+    }
+
+    SECTION("advancing from event to event expires every timer at its tick")
+    {
+        std::size_t wake_ups = 0;
+
+        while (wheel.size() > 0)
+        {
+            const std::uint64_t tick = wheel.next_event_tick();
+            ++wake_ups;
+
+            TimerLink expired;
+            wheel.advance(tick, expired);
+
+            while (!expired.empty())
+            {
+                auto* node = static_cast<TimerNode*>(expired.next);
+                node->unlink();
+                REQUIRE(node->expiry == tick);
+            }
+        }
+
+        REQUIRE(wake_ups < 2 * expiries.size()); // instead of one per tick
+    }
+
+    SECTION("timer with the expiry in the past expires with the next tick")
+    {
+        TimerLink expired;
+        wheel.advance(100, expired);
+
+        TimerNode late;
+        late.expiry = 50;
+        wheel.insert(&late);
+
+        TimerLink next;
+        wheel.advance(101, next);
+        REQUIRE(next.prev == &late);
+        late.unlink();
+    }
+}
+
+TEST_CASE("TimerWheel")
+{
+    static_thread_pool pool{2};
+    TimerWheel timers{pool};
+
+    SECTION("sleeping coroutines wake up in the order of deadlines")
+    {
+        std::mutex mtx;
+        std::vector<int> log;
+
+        sync_wait(when_all(
+            sleeper(timers, 30ms, mtx, log),
+            sleeper(timers, 10ms, mtx, log),
+            sleeper(timers, 20ms, mtx, log)));
+
+        REQUIRE(log == std::vector{10, 20, 30});
+    }
+
+    SECTION("sleep_for never wakes up early")
+    {
+        const auto start = TimerWheel::clock::now();
+        REQUIRE(sync_wait(sleep(timers, 15ms)));
+        REQUIRE(TimerWheel::clock::now() - start >= 15ms);
+    }
+
+    SECTION("deadline in the past does not suspend")
+    {
+        auto test = [&]() -> task<bool> { co_return co_await timers.deadline(TimerWheel::clock::now() - 1s); };
+
+        REQUIRE(sync_wait(test()));
+    }
+
+    SECTION("cancellation with a stop_token")
+    {
+        std::stop_source stop_source;
+
+        auto canceller = [&]() -> task<> {
+            co_await timers.sleep_for(5ms);
+            stop_source.request_stop();
+        };
+
+        const auto start = TimerWheel::clock::now();
+        auto [elapsed, cancelled] = sync_wait(when_all(sleep(timers, 1h, stop_source.get_token()), canceller()));
+
+        REQUIRE_FALSE(elapsed);
+        REQUIRE(TimerWheel::clock::now() - start < 1s);
+        REQUIRE(timers.pending() == 0);
+    }
+
+    SECTION("stop requested before co_await")
+    {
+        std::stop_source stop_source;
+        stop_source.request_stop();
+
+        REQUIRE_FALSE(sync_wait(sleep(timers, 1h, stop_source.get_token())));
+    }
+
+    SECTION("many timers at once")
+    {
+        REQUIRE(sync_wait(sleep_many(timers, 10'000, 50)) == 10'000);
+        REQUIRE(timers.pending() == 0);
+    }
+}
+
+TEST_CASE("TimerWheel - timers on the timer thread")
+{
+    TimerWheel timers{100us};
+
+    REQUIRE(timers.resolution() == 100us);
+    REQUIRE(sync_wait(sleep(timers, 10ms)));
+}
+
+TEST_CASE("TimerWheel - benchmarks", "[.][benchmark]")
+{
+    constexpr std::size_t count = 1'000'000;
+
+    std::mt19937_64 rnd{665};
+    std::uniform_int_distribution<std::uint64_t> distr{1, 60'000}; // up to a minute in 1 ms ticks
+    std::vector<std::uint64_t> expiries(count);
+    for (auto& expiry : expiries)
+        expiry = distr(rnd);
+
+    BENCHMARK_ADVANCED("start & cancel 1'000'000 timers - HierarchicalTimerWheel")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<detail::TimerNode> nodes(count);
+        for (std::size_t i = 0; i < count; ++i)
+            nodes[i].expiry = expiries[i];
+
+        meter.measure([&] {
+            detail::HierarchicalTimerWheel wheel;
+            for (auto& node : nodes)
+                wheel.insert(&node);
+            for (auto& node : nodes)
+                wheel.remove(&node);
+            return wheel.size();
+        });
+    };
+
+    BENCHMARK("start & expire 1'000'000 timers - std::priority_queue")
+    {
+        std::priority_queue<std::uint64_t, std::vector<std::uint64_t>, std::greater<>> queue;
+        for (std::uint64_t expiry : expiries)
+            queue.push(expiry);
+
+        std::uint64_t last = 0;
+        while (!queue.empty())
+        {
+            last = queue.top();
+            queue.pop();
+        }
+        return last;
+    };
+
+    BENCHMARK_ADVANCED("start & expire 1'000'000 timers - HierarchicalTimerWheel")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<detail::TimerNode> nodes(count);
+        for (std::size_t i = 0; i < count; ++i)
+            nodes[i].expiry = expiries[i];
+
+        meter.measure([&] {
+            detail::HierarchicalTimerWheel wheel;
+            for (auto& node : nodes)
+                wheel.insert(&node);
+
+            std::size_t expired_count = 0;
+            for (std::uint64_t tick = 0; wheel.size() > 0; ++tick)
+            {
+                detail::TimerLink expired;
+                wheel.advance(tick, expired);
+                while (!expired.empty())
+                {
+                    expired.next->unlink();
+                    ++expired_count;
+                }
+            }
+            return expired_count;
+        });
+    };
+
+    static_thread_pool pool{std::max(2u, std::thread::hardware_concurrency())};
+    TimerWheel timers{pool};
+
+    BENCHMARK("100'000 coroutines sleeping 1..100 ms on the pool")
+    {
+        return sync_wait(sleep_many(timers, 100'000, 100));
+    };
+}
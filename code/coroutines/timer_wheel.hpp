@@ -0,0 +1,484 @@
+#ifndef COROUTINES_TIMER_WHEEL_HPP
+#define COROUTINES_TIMER_WHEEL_HPP
+
+#include "static_thread_pool.hpp"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+
+namespace coro
+{
+    namespace detail
+    {
+        // link of an intrusive circular doubly-linked list - a standalone link is the list head
+        struct TimerLink
+        {
+            TimerLink* prev = this;
+            TimerLink* next = this;
+
+            TimerLink() = default;
+            TimerLink(const TimerLink&) = delete;
+            TimerLink& operator=(const TimerLink&) = delete;
+
+            bool empty() const noexcept
+            {
+                return next == this;
+            }
+
+            void push_back(TimerLink* link) noexcept
+            {
+                link->prev = prev;
+                link->next = this;
+                prev->next = link;
+                prev = link;
+            }
+
+            void unlink() noexcept
+            {
+                prev->next = next;
+                next->prev = prev;
+                prev = next = this;
+            }
+
+            // moves all links of the list to the end of other
+            void splice_to(TimerLink& other) noexcept
+            {
+                if (empty())
+                    return;
+
+                TimerLink* first = next;
+                TimerLink* last = prev;
+                prev = next = this;
+
+                first->prev = other.prev;
+                last->next = &other;
+                other.prev->next = first;
+                other.prev = last;
+            }
+        };
+
+        struct TimerNode : TimerLink
+        {
+            enum class State
+            {
+                created,
+                pending, // in the wheel
+                ready,   // expired or cancelled - waits to be resumed by the timer thread
+            };
+
+            std::uint64_t expiry = 0; // tick
+            std::coroutine_handle<> coro;
+            State state = State::created;
+            bool cancelled = false;
+        };
+
+        //////////////////////////////////////////////////////////////////
+        // hierarchical timer wheel (Varghese & Lauck) - not thread-safe
+        //   * 6 levels of 64 slots - level L holds timers due in less than 64^(L + 1) ticks,
+        //     the slot is picked by the bits of the expiry tick for the level
+        //   * insert & remove are O(1) - nodes are intrusive
+        //   * when level 0 wraps around, the matching slot of the next level is cascaded
+        //     (re-inserted) into the lower levels
+        //   * timers further than 64^6 ticks away wait in the last level & are re-cascaded
+        class HierarchicalTimerWheel
+        {
+            static constexpr unsigned slot_bits = 6;
+            static constexpr std::size_t slot_count = std::size_t{1} << slot_bits;
+            static constexpr std::uint64_t slot_mask = slot_count - 1;
+            static constexpr unsigned level_count = 6;
+            static constexpr std::uint64_t max_delta = (std::uint64_t{1} << (slot_bits * level_count)) - 1;
+
+            std::array<std::array<TimerLink, slot_count>, level_count> levels_;
+            std::uint64_t next_tick_ = 0; // next tick to expire
+            std::size_t size_ = 0;
+
+            void link(TimerNode* node) noexcept
+            {
+                std::uint64_t expiry = node->expiry < next_tick_ ? next_tick_ : node->expiry;
+                if (expiry - next_tick_ > max_delta)
+                    expiry = next_tick_ + max_delta;
+
+                const std::uint64_t delta = expiry - next_tick_;
+
+                unsigned level = 0;
+                while (level + 1 < level_count && delta >> (slot_bits * (level + 1)) != 0)
+                    ++level;
+
+                levels_[level][(expiry >> (slot_bits * level)) & slot_mask].push_back(node);
+            }
+
+            // re-inserts timers of the slot into lower levels, returns the index of the slot
+            std::uint64_t cascade(unsigned level) noexcept
+            {
+                const std::uint64_t index = (next_tick_ >> (slot_bits * level)) & slot_mask;
+
+                TimerLink slot;
+                levels_[level][index].splice_to(slot);
+
+                while (!slot.empty())
+                {
+                    auto* node = static_cast<TimerNode*>(slot.next);
+                    node->unlink();
+                    link(node);
+                }
+
+                return index;
+            }
+
+            // true if advancing to the tick (a multiple of slot_count) cascades a non-empty slot
+            bool cascades_at(std::uint64_t tick) const noexcept
+            {
+                for (unsigned level = 1; level < level_count; ++level)
+                {
+                    const std::uint64_t index = (tick >> (slot_bits * level)) & slot_mask;
+                    if (!levels_[level][index].empty())
+                        return true;
+                    if (index != 0)
+                        return false;
+                }
+                return false;
+            }
+
+        public:
+            HierarchicalTimerWheel() = default;
+            HierarchicalTimerWheel(const HierarchicalTimerWheel&) = delete;
+            HierarchicalTimerWheel& operator=(const HierarchicalTimerWheel&) = delete;
+
+            std::size_t size() const noexcept
+            {
+                return size_;
+            }
+
+            std::uint64_t next_tick() const noexcept
+            {
+                return next_tick_;
+            }
+
+            // the first tick at which advance() has work to do - a timer expires or a non-empty slot is cascaded
+            //   * no timer expires earlier - the timer thread can sleep until then
+            //   * searches at most slot_count level 0 slots & slot_count cascades ahead - then the tick
+            //     of the last checked cascade is returned
+            std::uint64_t next_event_tick() const noexcept
+            {
+                // level 0 holds the timers due in the next slot_count ticks
+                for (std::uint64_t tick = next_tick_; tick < next_tick_ + slot_count; ++tick)
+                {
+                    if ((tick & slot_mask) == 0 && cascades_at(tick))
+                        return tick;
+                    if (!levels_[0][tick & slot_mask].empty())
+                        return tick;
+                }
+
+                // from here on level 0 is filled only by cascades
+                std::uint64_t tick = (next_tick_ + slot_count + slot_mask) & ~slot_mask;
+                for (std::size_t i = 1; i < slot_count && !cascades_at(tick); ++i)
+                    tick += slot_count;
+                return tick;
+            }
+
+            // a timer with the expiry in the past expires with the next tick
+            void insert(TimerNode* node) noexcept
+            {
+                link(node);
+                ++size_;
+            }
+
+            void remove(TimerNode* node) noexcept
+            {
+                node->unlink();
+                --size_;
+            }
+
+            // expires all ticks up to now (inclusive) - expired nodes are moved to the end of expired
+            void advance(std::uint64_t now, TimerLink& expired) noexcept
+            {
+                if (size_ == 0)
+                {
+                    if (now >= next_tick_)
+                        next_tick_ = now + 1;
+                    return;
+                }
+
+                while (next_tick_ <= now && size_ > 0)
+                {
+                    const std::uint64_t index = next_tick_ & slot_mask;
+
+                    if (index == 0)
+                    {
+                        for (unsigned level = 1; level < level_count && cascade(level) == 0; ++level)
+                        {
+                        }
+                    }
+
+                    TimerLink& slot = levels_[0][index];
+                    for (TimerLink* link = slot.next; link != &slot; link = link->next)
+                    {
+                        static_cast<TimerNode*>(link)->state = TimerNode::State::ready;
+                        --size_;
+                    }
+                    slot.splice_to(expired);
+
+                    ++next_tick_;
+                }
+
+                if (size_ == 0 && now >= next_tick_)
+                    next_tick_ = now + 1;
+            }
+        };
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // TimerWheel - timers for coroutines driven by a single timer thread
+    //   * co_await timers.sleep_for(duration) / co_await timers.deadline(time_point)
+    //   * resolution of one tick (1 ms by default) - a timer never expires early
+    //   * starting & cancelling a timer is O(1) and allocation-free - the timer node
+    //     lives in the awaiter, i.e. in the frame of the sleeping coroutine
+    //   * cancellation: pass a std::stop_token - co_await returns false if the sleep
+    //     was cancelled, true if the time has elapsed
+    //   * expired coroutines are resumed on the timer thread or posted to a static_thread_pool
+    //   * coroutines still sleeping when the wheel is destroyed are never resumed
+    class TimerWheel
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+    private:
+        clock::duration resolution_;
+        clock::time_point start_ = clock::now();
+        static_thread_pool* pool_ = nullptr;
+
+        std::mutex mtx_;
+        std::condition_variable_any cv_;
+        detail::HierarchicalTimerWheel wheel_;
+        detail::TimerLink ready_; // expired & cancelled timers
+        std::uint64_t wake_tick_ = UINT64_MAX; // the timer thread sleeps until this tick - lowered by schedule()
+
+        std::jthread timer_thread_;
+
+        std::uint64_t tick_of(clock::time_point time_point) const noexcept
+        {
+            if (time_point <= start_)
+                return 0;
+
+            const auto ticks = (time_point - start_ + resolution_ - clock::duration{1}) / resolution_; // rounded up
+            return static_cast<std::uint64_t>(ticks);
+        }
+
+        clock::time_point time_of(std::uint64_t tick) const noexcept
+        {
+            return start_ + static_cast<clock::rep>(tick) * resolution_;
+        }
+
+        void resume(std::coroutine_handle<> coro)
+        {
+            if (pool_)
+                pool_->post(coro);
+            else
+                coro.resume();
+        }
+
+        void run(std::stop_token stop)
+        {
+            std::unique_lock lock{mtx_};
+
+            while (!stop.stop_requested())
+            {
+                const clock::time_point now = clock::now();
+                wheel_.advance(now < start_ ? 0 : static_cast<std::uint64_t>((now - start_) / resolution_), ready_);
+
+                if (!ready_.empty())
+                {
+                    detail::TimerLink ready;
+                    ready_.splice_to(ready);
+                    lock.unlock();
+
+                    while (!ready.empty())
+                    {
+                        auto* node = static_cast<detail::TimerNode*>(ready.next);
+                        node->unlink();
+                        resume(node->coro); // the node may be gone after this call
+                    }
+
+                    lock.lock();
+                    continue;
+                }
+
+                // sleeps until the next expiry or cascade - not every tick
+                const std::uint64_t wake_tick = wheel_.size() == 0 ? UINT64_MAX : wheel_.next_event_tick();
+                wake_tick_ = wake_tick;
+
+                const auto woken = [this, wake_tick] { return !ready_.empty() || wake_tick_ != wake_tick; };
+                if (wake_tick == UINT64_MAX)
+                    cv_.wait(lock, stop, woken);
+                else
+                    cv_.wait_until(lock, stop, time_of(wake_tick), woken);
+            }
+        }
+
+        void cancel(detail::TimerNode& node)
+        {
+            {
+                std::lock_guard lock{mtx_};
+
+                switch (node.state)
+                {
+                case detail::TimerNode::State::created: // await_suspend has not inserted the timer yet
+                    node.state = detail::TimerNode::State::ready;
+                    node.cancelled = true;
+                    return;
+                case detail::TimerNode::State::pending:
+                    wheel_.remove(&node);
+                    node.state = detail::TimerNode::State::ready;
+                    node.cancelled = true;
+                    ready_.push_back(&node);
+                    break;
+                case detail::TimerNode::State::ready:
+                    return;
+                }
+            }
+
+            cv_.notify_one();
+        }
+
+        // false - the timer was cancelled before it could be inserted
+        bool schedule(detail::TimerNode& node)
+        {
+            bool expires_earlier;
+
+            {
+                std::lock_guard lock{mtx_};
+
+                if (node.state != detail::TimerNode::State::created)
+                    return false;
+
+                node.state = detail::TimerNode::State::pending;
+                wheel_.insert(&node);
+
+                // the timer thread sleeps past the expiry - it has to recompute its wake-up tick
+                expires_earlier = node.expiry < wake_tick_;
+                if (expires_earlier)
+                    wake_tick_ = node.expiry;
+            }
+
+            if (expires_earlier)
+                cv_.notify_one();
+            return true;
+        }
+
+    public:
+        class SleepOperation : detail::TimerNode
+        {
+            struct Cancel
+            {
+                SleepOperation* operation;
+
+                void operator()() const
+                {
+                    operation->wheel_.cancel(*operation);
+                }
+            };
+
+            TimerWheel& wheel_;
+            clock::time_point deadline_;
+            std::stop_token stop_token_;
+            std::optional<std::stop_callback<Cancel>> on_stop_;
+
+        public:
+            SleepOperation(TimerWheel& wheel, clock::time_point deadline, std::stop_token stop_token) noexcept
+                : wheel_{wheel}
+                , deadline_{deadline}
+                , stop_token_{std::move(stop_token)}
+            {
+            }
+
+            SleepOperation(const SleepOperation&) = delete;
+            SleepOperation& operator=(const SleepOperation&) = delete;
+
+            bool await_ready() noexcept
+            {
+                if (stop_token_.stop_requested())
+                {
+                    this->cancelled = true;
+                    return true;
+                }
+
+                return deadline_ <= clock::now();
+            }
+
+            bool await_suspend(std::coroutine_handle<> coro)
+            {
+                this->coro = coro;
+                this->expiry = wheel_.tick_of(deadline_);
+
+                // registered before the timer is inserted - a stop requested in between
+                // is seen by schedule() and the coroutine is not suspended at all
+                if (stop_token_.stop_possible())
+                    on_stop_.emplace(stop_token_, Cancel{this});
+
+                return wheel_.schedule(*this);
+            }
+
+            // true - the time has elapsed, false - the sleep was cancelled
+            bool await_resume() const noexcept
+            {
+                return !this->cancelled;
+            }
+        };
+
+        explicit TimerWheel(clock::duration resolution = std::chrono::milliseconds{1})
+            : resolution_{resolution}
+            , timer_thread_{[this](std::stop_token stop) { run(stop); }}
+        {
+        }
+
+        // expired coroutines are resumed on the workers of the pool
+        explicit TimerWheel(static_thread_pool& pool, clock::duration resolution = std::chrono::milliseconds{1})
+            : resolution_{resolution}
+            , pool_{&pool}
+            , timer_thread_{[this](std::stop_token stop) { run(stop); }}
+        {
+        }
+
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+        ~TimerWheel()
+        {
+            timer_thread_.request_stop();
+            timer_thread_.join();
+        }
+
+        clock::duration resolution() const noexcept
+        {
+            return resolution_;
+        }
+
+        // number of timers waiting in the wheel
+        std::size_t pending()
+        {
+            std::lock_guard lock{mtx_};
+            return wheel_.size();
+        }
+
+        template <typename Rep, typename Period>
+        [[nodiscard]] SleepOperation sleep_for(std::chrono::duration<Rep, Period> duration, std::stop_token stop_token = {})
+        {
+            return SleepOperation{*this, clock::now() + std::chrono::ceil<clock::duration>(duration), std::move(stop_token)};
+        }
+
+        [[nodiscard]] SleepOperation deadline(clock::time_point time_point, std::stop_token stop_token = {})
+        {
+            return SleepOperation{*this, time_point, std::move(stop_token)};
+        }
+    };
+}
+
+#endif //COROUTINES_TIMER_WHEEL_HPP
@@ -0,0 +1,223 @@
+#ifndef COROUTINES_WHEN_ALL_HPP
+#define COROUTINES_WHEN_ALL_HPP
+
+#include "awaitable_traits.hpp"
+#include "task.hpp"
+
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace coro
+{
+    namespace detail
+    {
+        // resumes the awaiting coroutine when the last of the children completes
+        class WhenAllLatch
+        {
+            std::atomic<std::size_t> count_;
+            std::coroutine_handle<> awaiting_;
+
+        public:
+            explicit WhenAllLatch(std::size_t children) noexcept
+                : count_{children + 1}
+            {
+            }
+
+            // false if all children have already completed
+            bool try_await(std::coroutine_handle<> awaiting) noexcept
+            {
+                awaiting_ = awaiting;
+                return count_.fetch_sub(1, std::memory_order_acq_rel) > 1;
+            }
+
+            void notify_completed() noexcept
+            {
+                if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    awaiting_.resume();
+            }
+        };
+
+        // awaits a single child of when_all and reports its completion to the latch
+        class WhenAllTask
+        {
+        public:
+            struct promise_type : Cancellable
+            {
+                WhenAllLatch* latch = nullptr;
+                std::exception_ptr exception;
+
+                WhenAllTask get_return_object() noexcept
+                {
+                    return WhenAllTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+                }
+
+                std::suspend_always initial_suspend() const noexcept
+                {
+                    return {};
+                }
+
+                auto final_suspend() const noexcept
+                {
+                    struct Notify
+                    {
+                        bool await_ready() const noexcept
+                        {
+                            return false;
+                        }
+
+                        void await_suspend(std::coroutine_handle<promise_type> coro) const noexcept
+                        {
+                            coro.promise().latch->notify_completed();
+                        }
+
+                        void await_resume() const noexcept
+                        {
+                        }
+                    };
+
+                    return Notify{};
+                }
+
+                void return_void() const noexcept
+                {
+                }
+
+                void unhandled_exception() noexcept
+                {
+                    exception = std::current_exception();
+                }
+            };
+
+            explicit WhenAllTask(std::coroutine_handle<promise_type> coro) noexcept
+                : coro_{coro}
+            {
+            }
+
+            WhenAllTask(WhenAllTask&& other) noexcept
+                : coro_{std::exchange(other.coro_, nullptr)}
+            {
+            }
+
+            ~WhenAllTask()
+            {
+                if (coro_)
+                    coro_.destroy();
+            }
+
+            template <typename TPromise>
+            void start(WhenAllLatch& latch, std::coroutine_handle<TPromise> awaiting) noexcept
+            {
+                coro_.promise().latch = &latch;
+                coro_.promise().inherit_stop_token(awaiting);
+                coro_.resume();
+            }
+
+            void rethrow_if_exception() const
+            {
+                if (coro_.promise().exception)
+                    std::rethrow_exception(coro_.promise().exception);
+            }
+
+        private:
+            std::coroutine_handle<promise_type> coro_;
+        };
+
+        template <typename TAwaitable>
+        WhenAllTask make_when_all_task(TAwaitable& awaitable, std::optional<stored_await_result_t<TAwaitable>>& result)
+        {
+            if constexpr (std::is_void_v<await_result_t<TAwaitable>>)
+            {
+                co_await std::move(awaitable);
+                result.emplace();
+            }
+            else
+                result.emplace(co_await std::move(awaitable));
+        }
+
+        // starts all children and suspends until the last one completes
+        template <typename TChildren>
+        class WhenAllAwaiter
+        {
+            TChildren& children_;
+            WhenAllLatch latch_;
+
+        public:
+            explicit WhenAllAwaiter(TChildren& children) noexcept
+                : children_{children}
+                , latch_{std::size(children)}
+            {
+            }
+
+            bool await_ready() const noexcept
+            {
+                return std::size(children_) == 0;
+            }
+
+            // children inherit the stop token of the awaiting task
+            template <typename TPromise>
+            bool await_suspend(std::coroutine_handle<TPromise> awaiting) noexcept
+            {
+                for (WhenAllTask& child : children_)
+                    child.start(latch_, awaiting);
+                return latch_.try_await(awaiting);
+            }
+
+            // the first exception (in the order of arguments) is rethrown
+            void await_resume() const
+            {
+                for (const WhenAllTask& child : children_)
+                    child.rethrow_if_exception();
+            }
+        };
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // when_all - awaits all awaitables concurrently
+    //   * lazy: nothing starts until the returned task is awaited
+    //   * children run until their first suspension one after another on the awaiting thread,
+    //     the awaiting coroutine is resumed by the child that completes last
+    //   * results are returned in the order of arguments (void -> std::monostate)
+    //   * when a child throws, all children are still awaited before the exception is rethrown
+    template <typename... TAwaitables>
+        requires(sizeof...(TAwaitables) > 0)
+    task<std::tuple<stored_await_result_t<TAwaitables>...>> when_all(TAwaitables... awaitables)
+    {
+        std::tuple<std::optional<stored_await_result_t<TAwaitables>>...> results;
+
+        std::array<detail::WhenAllTask, sizeof...(TAwaitables)> children = std::apply(
+            [&](auto&... result) { return std::array{detail::make_when_all_task(awaitables, result)...}; }, results);
+
+        co_await detail::WhenAllAwaiter{children};
+
+        co_return std::apply(
+            [](auto&... result) { return std::tuple<stored_await_result_t<TAwaitables>...>{std::move(*result)...}; }, results);
+    }
+
+    template <typename TAwaitable>
+    auto when_all(std::vector<TAwaitable> awaitables) -> task<std::vector<stored_await_result_t<TAwaitable>>>
+    {
+        std::vector<std::optional<stored_await_result_t<TAwaitable>>> results(awaitables.size());
+
+        std::vector<detail::WhenAllTask> children;
+        children.reserve(awaitables.size());
+        for (std::size_t i = 0; i < awaitables.size(); ++i)
+            children.push_back(detail::make_when_all_task(awaitables[i], results[i]));
+
+        co_await detail::WhenAllAwaiter{children};
+
+        std::vector<stored_await_result_t<TAwaitable>> values;
+        values.reserve(results.size());
+        for (auto& result : results)
+            values.push_back(std::move(*result));
+        co_return values;
+    }
+}
+
+#endif //COROUTINES_WHEN_ALL_HPP
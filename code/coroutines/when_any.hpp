@@ -0,0 +1,167 @@
+#ifndef COROUTINES_WHEN_ANY_HPP
+#define COROUTINES_WHEN_ANY_HPP
+
+#include "awaitable_traits.hpp"
+#include "task.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace coro
+{
+    template <typename T>
+    struct WhenAnyResult
+    {
+        std::size_t index; // position of the awaitable that completed first
+        T value;
+    };
+
+    namespace detail
+    {
+        template <typename TAwaitable>
+        struct WhenAnyState
+        {
+            using Result = stored_await_result_t<TAwaitable>;
+
+            std::vector<TAwaitable> awaitables;
+            std::atomic<bool> has_winner{false};
+            std::atomic<bool> rendezvous{false}; // the second of (winner, awaiting coroutine) resumes the awaiting one
+            std::coroutine_handle<> awaiting;
+            std::size_t index{};
+            std::optional<Result> value;
+            std::exception_ptr exception;
+
+            explicit WhenAnyState(std::vector<TAwaitable> awaitables)
+                : awaitables{std::move(awaitables)}
+            {
+            }
+
+            void complete(std::size_t i, std::optional<Result>&& result, std::exception_ptr error) noexcept
+            {
+                if (has_winner.exchange(true, std::memory_order_acq_rel))
+                    return;
+
+                index = i;
+                value = std::move(result);
+                exception = std::move(error);
+
+                if (rendezvous.exchange(true, std::memory_order_acq_rel))
+                    awaiting.resume();
+            }
+        };
+
+        // fire-and-forget coroutine - destroys itself on completion, keeps the shared state alive
+        struct DetachedTask
+        {
+            struct promise_type
+            {
+                DetachedTask get_return_object() noexcept
+                {
+                    return {};
+                }
+
+                std::suspend_never initial_suspend() const noexcept
+                {
+                    return {};
+                }
+
+                std::suspend_never final_suspend() const noexcept
+                {
+                    return {};
+                }
+
+                void return_void() const noexcept
+                {
+                }
+
+                void unhandled_exception() const noexcept
+                {
+                    std::terminate();
+                }
+            };
+        };
+
+        template <typename TAwaitable>
+        DetachedTask run_when_any_child(std::shared_ptr<WhenAnyState<TAwaitable>> state, std::size_t i)
+        {
+            std::optional<stored_await_result_t<TAwaitable>> result;
+            std::exception_ptr error;
+
+            try
+            {
+                if constexpr (std::is_void_v<await_result_t<TAwaitable>>)
+                {
+                    co_await std::move(state->awaitables[i]);
+                    result.emplace();
+                }
+                else
+                    result.emplace(co_await std::move(state->awaitables[i]));
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            state->complete(i, std::move(result), std::move(error));
+        }
+
+        // refers to the state owned by when_any - GCC 12 may destroy a temporary awaiter twice,
+        // so the awaiter must not own a shared_ptr
+        template <typename TAwaitable>
+        struct WhenAnyAwaiter
+        {
+            const std::shared_ptr<WhenAnyState<TAwaitable>>& state;
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            bool await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                state->awaiting = awaiting;
+
+                for (std::size_t i = 0; i < state->awaitables.size(); ++i)
+                    run_when_any_child(state, i);
+
+                return !state->rendezvous.exchange(true, std::memory_order_acq_rel);
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // when_any - awaits the first of the awaitables to complete
+    //   * lazy: nothing starts until the returned task is awaited
+    //   * returns the index and the result of the first completed awaitable
+    //     (an exception from the first one is rethrown)
+    //   * the remaining awaitables keep running detached - their frames and results
+    //     are released when the last of them completes
+    template <typename TAwaitable>
+    auto when_any(std::vector<TAwaitable> awaitables) -> task<WhenAnyResult<stored_await_result_t<TAwaitable>>>
+    {
+        if (awaitables.empty())
+            throw std::invalid_argument{"when_any requires at least one awaitable"};
+
+        auto state = std::make_shared<detail::WhenAnyState<TAwaitable>>(std::move(awaitables));
+
+        co_await detail::WhenAnyAwaiter<TAwaitable>{state};
+
+        if (state->exception)
+            std::rethrow_exception(state->exception);
+
+        co_return WhenAnyResult<stored_await_result_t<TAwaitable>>{state->index, std::move(*state->value)};
+    }
+}
+
+#endif //COROUTINES_WHEN_ANY_HPP
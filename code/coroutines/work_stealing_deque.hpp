@@ -0,0 +1,161 @@
+#ifndef COROUTINES_WORK_STEALING_DEQUE_HPP
+#define COROUTINES_WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace coro
+{
+    //////////////////////////////////////////////////////////////////
+    // WorkStealingDeque<T> - Chase-Lev deque (Le, Pop, Cohen, Zappa Nardelli - PPoPP 2013)
+    //   * the owner thread pushes and pops at the bottom (LIFO)
+    //   * other threads steal from the top (FIFO)
+    //   * T must be a pointer-like trivially copyable type with a null value (empty result)
+    //   * the buffer grows on demand - retired buffers are kept until the deque is destroyed,
+    //     because a concurrent thief may still read from them
+    template <typename T>
+    class WorkStealingDeque
+    {
+        static_assert(std::is_trivially_copyable_v<T> && std::atomic<T>::is_always_lock_free);
+
+        class Buffer
+        {
+            std::int64_t capacity_;
+            std::unique_ptr<std::atomic<T>[]> items_;
+
+        public:
+            explicit Buffer(std::int64_t capacity)
+                : capacity_{capacity}
+                , items_{new std::atomic<T>[static_cast<std::size_t>(capacity)]}
+            {
+            }
+
+            std::int64_t capacity() const noexcept
+            {
+                return capacity_;
+            }
+
+            T get(std::int64_t index) const noexcept
+            {
+                return items_[static_cast<std::size_t>(index & (capacity_ - 1))].load(std::memory_order_relaxed);
+            }
+
+            void put(std::int64_t index, T item) noexcept
+            {
+                items_[static_cast<std::size_t>(index & (capacity_ - 1))].store(item, std::memory_order_relaxed);
+            }
+        };
+
+        static constexpr std::size_t cache_line = 64;
+
+        alignas(cache_line) std::atomic<std::int64_t> top_{0};
+        alignas(cache_line) std::atomic<std::int64_t> bottom_{0};
+        alignas(cache_line) std::atomic<Buffer*> buffer_;
+        std::vector<std::unique_ptr<Buffer>> buffers_; // owned by the owner thread
+
+        Buffer* grow(Buffer* old, std::int64_t top, std::int64_t bottom)
+        {
+            auto bigger = std::make_unique<Buffer>(old->capacity() * 2);
+            for (std::int64_t i = top; i < bottom; ++i)
+                bigger->put(i, old->get(i));
+
+            Buffer* result = bigger.get();
+            buffers_.push_back(std::move(bigger));
+            buffer_.store(result, std::memory_order_release);
+            return result;
+        }
+
+    public:
+        explicit WorkStealingDeque(std::int64_t initial_capacity = 256)
+        {
+            std::int64_t capacity = 1;
+            while (capacity < initial_capacity)
+                capacity *= 2;
+
+            buffers_.push_back(std::make_unique<Buffer>(capacity));
+            buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+        }
+
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        // owner only
+        void push(T item)
+        {
+            const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+            const std::int64_t top = top_.load(std::memory_order_acquire);
+            Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+
+            if (bottom - top > buffer->capacity() - 1)
+                buffer = grow(buffer, top, bottom);
+
+            buffer->put(bottom, item);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        // owner only - T{} if empty
+        T pop() noexcept
+        {
+            const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+            Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+            bottom_.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t top = top_.load(std::memory_order_relaxed);
+
+            if (top > bottom) // empty
+            {
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+                return T{};
+            }
+
+            T item = buffer->get(bottom);
+
+            if (top == bottom) // the last item - race against thieves
+            {
+                if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    item = T{};
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return item;
+        }
+
+        // any thread - T{} if empty or lost a race
+        T steal() noexcept
+        {
+            std::int64_t top = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+                return T{};
+
+            T item = buffer_.load(std::memory_order_acquire)->get(top);
+
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return T{};
+
+            return item;
+        }
+
+        // approximate when other threads operate on the deque
+        std::int64_t size() const noexcept
+        {
+            const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+            const std::int64_t top = top_.load(std::memory_order_relaxed);
+            return bottom > top ? bottom - top : 0;
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+    };
+}
+
+#endif //COROUTINES_WORK_STEALING_DEQUE_HPP
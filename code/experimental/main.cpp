@@ -1,3 +1,4 @@
 #define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 
 #include "catch.hpp"
\ No newline at end of file
@@ -0,0 +1,563 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////
+// tick-tock protocol as a stackless state machine
+//   * every component is a coroutine awaiting the next message from its mailbox
+//   * send_down/send_up only post to mailboxes - no recursion, so the depth of a tree
+//     is limited by the memory, not by the stack
+//   * coroutines of many trees are interleaved on a few worker threads
+namespace Coroutines
+{
+    struct Start {};
+    struct Tick {};
+    struct Tock {};
+    struct Stop {};
+
+    using Message = std::variant<Start, Tick, Tock, Stop>;
+
+    class Scheduler;
+
+    // fire-and-forget coroutine of a component - started & resumed by the Scheduler
+    class actor
+    {
+    public:
+        struct promise_type
+        {
+            Scheduler* scheduler = nullptr;
+
+            actor get_return_object() noexcept
+            {
+                return actor{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            std::suspend_always initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept
+                {
+                    return false;
+                }
+
+                void await_suspend(std::coroutine_handle<promise_type> coro) noexcept;
+
+                void await_resume() noexcept
+                {
+                }
+            };
+
+            FinalAwaiter final_suspend() noexcept
+            {
+                return {};
+            }
+
+            void return_void() noexcept
+            {
+            }
+
+            void unhandled_exception() noexcept
+            {
+                std::terminate();
+            }
+        };
+
+        actor() = default;
+
+        explicit actor(std::coroutine_handle<promise_type> coro) noexcept
+            : coro_{coro}
+        {
+        }
+
+        actor(actor&& other) noexcept
+            : coro_{std::exchange(other.coro_, nullptr)}
+        {
+        }
+
+        actor& operator=(actor&& other) noexcept
+        {
+            actor temp{std::move(other)};
+            std::swap(coro_, temp.coro_);
+            return *this;
+        }
+
+        ~actor()
+        {
+            if (coro_)
+                coro_.destroy();
+        }
+
+        std::coroutine_handle<promise_type> handle() const noexcept
+        {
+            return coro_;
+        }
+
+    private:
+        std::coroutine_handle<promise_type> coro_;
+    };
+
+    //////////////////////////////////////////////////////////////////
+    // Scheduler - FIFO run queue served by a fixed number of worker threads
+    class Scheduler
+    {
+        std::mutex mtx_;
+        std::condition_variable_any cv_;
+        std::deque<std::coroutine_handle<>> run_queue_;
+        unsigned sleeping_ = 0; // workers waiting for the run queue
+
+        std::mutex alive_mtx_;
+        std::condition_variable alive_cv_;
+        std::size_t alive_ = 0;
+
+        std::vector<std::jthread> workers_;
+
+        void run(std::stop_token stop)
+        {
+            while (true)
+            {
+                std::coroutine_handle<> coro;
+
+                {
+                    std::unique_lock lock{mtx_};
+                    if (run_queue_.empty())
+                    {
+                        ++sleeping_;
+                        const bool woken = cv_.wait(lock, stop, [this] { return !run_queue_.empty(); });
+                        --sleeping_;
+                        if (!woken)
+                            return;
+                    }
+
+                    coro = run_queue_.front();
+                    run_queue_.pop_front();
+                }
+
+                coro.resume();
+            }
+        }
+
+    public:
+        explicit Scheduler(unsigned thread_count = std::max(1u, std::thread::hardware_concurrency()))
+        {
+            for (unsigned i = 0; i < thread_count; ++i)
+                workers_.emplace_back([this](std::stop_token stop) { run(stop); });
+        }
+
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        void post(std::coroutine_handle<> coro)
+        {
+            bool wake_up;
+
+            {
+                std::lock_guard lock{mtx_};
+                run_queue_.push_back(coro);
+                wake_up = sleeping_ > 0;
+            }
+
+            if (wake_up) // a busy worker picks the coroutine up anyway
+                cv_.notify_one();
+        }
+
+        void spawn(const actor& a)
+        {
+            {
+                std::lock_guard lock{alive_mtx_};
+                ++alive_;
+            }
+
+            a.handle().promise().scheduler = this;
+            post(a.handle());
+        }
+
+        void actor_done()
+        {
+            {
+                std::lock_guard lock{alive_mtx_};
+                --alive_;
+            }
+            alive_cv_.notify_all();
+        }
+
+        // blocks until all spawned actors have finished
+        void wait_idle()
+        {
+            std::unique_lock lock{alive_mtx_};
+            alive_cv_.wait(lock, [this] { return alive_ == 0; });
+        }
+    };
+
+    // the frame is suspended - the owner may destroy it as soon as wait_idle() returns
+    inline void actor::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> coro) noexcept
+    {
+        coro.promise().scheduler->actor_done();
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // Mailbox - multiple producers, a single consumer (the coroutine of the component)
+    class Mailbox
+    {
+        Scheduler& scheduler_;
+        std::mutex mtx_;
+        std::deque<Message> messages_;
+        std::coroutine_handle<> waiting_;
+        std::size_t received_ = 0; // touched only by the consumer
+
+        Message take() // mtx_ is locked or the consumer was woken up by post()
+        {
+            Message msg = std::move(messages_.front());
+            messages_.pop_front();
+            ++received_;
+            return msg;
+        }
+
+    public:
+        explicit Mailbox(Scheduler& scheduler)
+            : scheduler_{scheduler}
+        {
+        }
+
+        Mailbox(const Mailbox&) = delete;
+        Mailbox& operator=(const Mailbox&) = delete;
+
+        void post(Message msg)
+        {
+            std::coroutine_handle<> consumer;
+
+            {
+                std::lock_guard lock{mtx_};
+                messages_.push_back(std::move(msg));
+                consumer = std::exchange(waiting_, nullptr);
+            }
+
+            if (consumer)
+                scheduler_.post(consumer);
+        }
+
+        std::size_t received() const noexcept
+        {
+            return received_;
+        }
+
+        class ReceiveOperation
+        {
+            Mailbox& mailbox_;
+            std::optional<Message> msg_;
+
+        public:
+            explicit ReceiveOperation(Mailbox& mailbox) noexcept
+                : mailbox_{mailbox}
+            {
+            }
+
+            bool await_ready()
+            {
+                std::lock_guard lock{mailbox_.mtx_};
+                if (mailbox_.messages_.empty())
+                    return false;
+
+                msg_.emplace(mailbox_.take());
+                return true;
+            }
+
+            bool await_suspend(std::coroutine_handle<> coro)
+            {
+                std::lock_guard lock{mailbox_.mtx_};
+                if (!mailbox_.messages_.empty())
+                {
+                    msg_.emplace(mailbox_.take());
+                    return false;
+                }
+
+                mailbox_.waiting_ = coro;
+                return true;
+            }
+
+            Message await_resume()
+            {
+                if (msg_)
+                    return std::move(*msg_);
+
+                std::lock_guard lock{mailbox_.mtx_};
+                return mailbox_.take();
+            }
+        };
+
+        [[nodiscard]] ReceiveOperation receive() noexcept
+        {
+            return ReceiveOperation{*this};
+        }
+    };
+
+    class Component
+    {
+        Mailbox mailbox_;
+        Component* parent_;
+        std::vector<Component*> children_;
+        actor behaviour_;
+
+    public:
+        Component(Scheduler& scheduler, Component* parent)
+            : mailbox_{scheduler}
+            , parent_{parent}
+        {
+            if (parent_)
+                parent_->children_.push_back(this);
+        }
+
+        Component(const Component&) = delete;
+        Component& operator=(const Component&) = delete;
+
+        void set_behaviour(actor behaviour)
+        {
+            behaviour_ = std::move(behaviour);
+        }
+
+        const actor& behaviour() const noexcept
+        {
+            return behaviour_;
+        }
+
+        void post(const Message& msg)
+        {
+            mailbox_.post(msg);
+        }
+
+        void send_down(const Message& msg)
+        {
+            for (Component* child : children_)
+                child->post(msg);
+        }
+
+        void send_up(const Message& msg)
+        {
+            if (parent_)
+                parent_->post(msg);
+        }
+
+        [[nodiscard]] auto receive() noexcept
+        {
+            return mailbox_.receive();
+        }
+
+        std::size_t received() const noexcept
+        {
+            return mailbox_.received();
+        }
+    };
+
+    //////////////////////////////////////////////////////////////////
+    // ComponentTree - owns the components of a tree in a flat list
+    //   * the destruction is not recursive either
+    //   * the coroutine of a component is spawned as soon as the component is added
+    class ComponentTree
+    {
+        Scheduler& scheduler_;
+        std::vector<std::unique_ptr<Component>> components_;
+
+    public:
+        explicit ComponentTree(Scheduler& scheduler)
+            : scheduler_{scheduler}
+        {
+        }
+
+        template <typename TBehaviour, typename... TArgs>
+        Component& add(Component* parent, TBehaviour behaviour, TArgs&&... args)
+        {
+            Component& component = *components_.emplace_back(std::make_unique<Component>(scheduler_, parent));
+            component.set_behaviour(behaviour(component, std::forward<TArgs>(args)...));
+            scheduler_.spawn(component.behaviour());
+            return component;
+        }
+
+        Component& root() const
+        {
+            return *components_.front();
+        }
+
+        std::size_t size() const noexcept
+        {
+            return components_.size();
+        }
+
+        // messages received by all components - valid when the coroutines have finished
+        std::size_t messages() const
+        {
+            std::size_t total = 0;
+            for (const auto& component : components_)
+                total += component->received();
+            return total;
+        }
+    };
+
+    // sends rounds of Ticks down & waits for Tocks of all responders, then stops the tree
+    actor tick_tock(Component& self, int rounds, std::size_t responders)
+    {
+        while (true)
+        {
+            Message msg = co_await self.receive();
+            if (std::holds_alternative<Start>(msg))
+                break;
+        }
+
+        for (int round = 0; round < rounds; ++round)
+        {
+            self.send_down(Tick{});
+
+            for (std::size_t tocks = 0; tocks < responders;)
+            {
+                Message msg = co_await self.receive();
+                if (std::holds_alternative<Tock>(msg))
+                    ++tocks;
+            }
+        }
+
+        self.send_down(Stop{});
+    }
+
+    actor idle(Component& self)
+    {
+        while (true)
+        {
+            Message msg = co_await self.receive();
+
+            if (std::holds_alternative<Tick>(msg))
+                self.send_down(msg);
+            else if (std::holds_alternative<Tock>(msg))
+                self.send_up(msg);
+            else if (std::holds_alternative<Stop>(msg))
+            {
+                self.send_down(msg);
+                co_return;
+            }
+        }
+    }
+
+    actor responder(Component& self)
+    {
+        while (true)
+        {
+            Message msg = co_await self.receive();
+
+            if (std::holds_alternative<Tick>(msg))
+                self.send_up(Tock{});
+            else if (std::holds_alternative<Stop>(msg))
+                co_return;
+        }
+    }
+
+    // tick_tock -> idle1 -> { responder1, idle2 -> responder2 } - the tree of tick_tock_runtime.cpp
+    void build_tick_tock_tree(ComponentTree& tree, int rounds)
+    {
+        Component& root = tree.add(nullptr, tick_tock, rounds, std::size_t{2});
+        Component& idle1 = tree.add(&root, idle);
+        tree.add(&idle1, responder);
+        Component& idle2 = tree.add(&idle1, idle);
+        tree.add(&idle2, responder);
+    }
+}
+
+TEST_CASE("tick-tock with coroutines")
+{
+    using namespace Coroutines;
+
+    Scheduler scheduler{4};
+
+    SECTION("a single tree")
+    {
+        ComponentTree tree{scheduler};
+        build_tick_tock_tree(tree, 3);
+
+        tree.root().post(Start{});
+        scheduler.wait_idle();
+
+        // Start + 9 messages per round (4 Ticks & 5 Tocks) + 4 Stops
+        REQUIRE(tree.messages() == 1 + 9 * 3 + 4);
+    }
+
+    SECTION("thousands of trees interleaved on a few threads")
+    {
+        std::vector<std::unique_ptr<ComponentTree>> trees;
+        for (int i = 0; i < 2'000; ++i)
+        {
+            build_tick_tock_tree(*trees.emplace_back(std::make_unique<ComponentTree>(scheduler)), 10);
+            trees.back()->root().post(Start{});
+        }
+
+        scheduler.wait_idle();
+
+        REQUIRE(std::all_of(trees.begin(), trees.end(), [](const auto& tree) { return tree->messages() == 1 + 9 * 10 + 4; }));
+    }
+
+    SECTION("deep tree does not overflow the stack")
+    {
+        constexpr std::size_t depth = 100'000;
+
+        ComponentTree tree{scheduler};
+        Component* parent = &tree.add(nullptr, tick_tock, 2, std::size_t{1});
+        for (std::size_t i = 0; i < depth; ++i)
+            parent = &tree.add(parent, idle);
+        tree.add(parent, responder);
+
+        tree.root().post(Start{});
+        scheduler.wait_idle();
+
+        const std::size_t n = depth + 1; // components below the root
+        REQUIRE(tree.messages() == 1 + 2 * (2 * n) + n);
+    }
+}
+
+TEST_CASE("tick-tock with coroutines - benchmarks", "[.][benchmark]")
+{
+    using namespace Coroutines;
+
+    constexpr int tree_count = 1'000;
+    constexpr int rounds = 100;
+
+    // every run gets its own scheduler - wait_idle() waits for all actors spawned on it
+    struct Run
+    {
+        std::unique_ptr<Scheduler> scheduler;
+        std::vector<std::unique_ptr<ComponentTree>> trees;
+    };
+
+    for (unsigned thread_count : {1u, 4u})
+    {
+        BENCHMARK_ADVANCED("1'000 trees x 100 rounds (900'000 messages) - coroutines on " + std::to_string(thread_count) + " thread(s)")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<Run> runs(meter.runs());
+            for (auto& run : runs)
+            {
+                run.scheduler = std::make_unique<Scheduler>(thread_count);
+                for (int i = 0; i < tree_count; ++i)
+                    build_tick_tock_tree(*run.trees.emplace_back(std::make_unique<ComponentTree>(*run.scheduler)), rounds);
+            }
+
+            meter.measure([&](int i) {
+                for (auto& tree : runs[i].trees)
+                    tree->root().post(Start{});
+                runs[i].scheduler->wait_idle();
+                return runs[i].trees.size();
+            });
+        };
+    }
+}
@@ -1,6 +1,10 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include "catch.hpp"
 #include <iostream>
 #include <concepts>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace Classic
 {
@@ -19,7 +23,7 @@ namespace Classic
     class ComponentBase
     {        
         std::string id_;
-        ComponentBase* parent_;
+        ComponentBase* parent_ = nullptr;
         std::vector<std::unique_ptr<ComponentBase>> children_;
 
     public:
@@ -167,3 +171,93 @@ namespace Classic
     
 //     tick_tock.process_event(Start{});
 // }
+
+
+namespace Classic::Counting
+{
+    // tick-tock components without the console output - the baseline for tick_tock_coroutines.cpp
+
+    struct TickTock : Component<Start, Tock>
+    {
+        using Component<Start, Tock>::Component;
+
+        int rounds = 1;
+        std::size_t messages = 0;
+
+        void handle(const Start&) override
+        {
+            ++messages;
+            for (int round = 0; round < rounds; ++round)
+                send_down(Tick{});
+        }
+
+        void handle(const Tock&) override
+        {
+            ++messages;
+        }
+    };
+
+    struct Idle : Component<Tick, Tock>
+    {
+        using Component<Tick, Tock>::Component;
+
+        std::size_t messages = 0;
+
+        void handle(const Tick& msg) override
+        {
+            ++messages;
+            send_down(msg);
+        }
+
+        void handle(const Tock& msg) override
+        {
+            ++messages;
+            send_up(msg);
+        }
+    };
+
+    struct Responder : Component<Tick>
+    {
+        using Component<Tick>::Component;
+
+        std::size_t messages = 0;
+
+        void handle(const Tick&) override
+        {
+            ++messages;
+            send_up(Tock{});
+        }
+    };
+}
+
+TEST_CASE("tick-tock recursive - benchmarks", "[.][benchmark]")
+{
+    using namespace Classic::Counting;
+
+    constexpr int tree_count = 1'000;
+    constexpr int rounds = 100;
+
+    std::vector<std::unique_ptr<TickTock>> trees;
+    for (int i = 0; i < tree_count; ++i)
+    {
+        trees.push_back(std::make_unique<TickTock>(
+            "tick_tock",
+                std::make_unique<Idle>("idle1",
+                    std::make_unique<Responder>("responder1"),
+                    std::make_unique<Idle>("idle2",
+                        std::make_unique<Responder>("responder2")
+                    )
+                )
+            ));
+        trees.back()->rounds = rounds;
+    }
+
+    BENCHMARK("1'000 trees x 100 rounds (900'000 messages) - recursive send_down/send_up")
+    {
+        for (auto& tree : trees)
+            tree->process_event(Classic::Start{});
+        return trees.size();
+    };
+
+    REQUIRE(trees.front()->messages % (1 + 2 * rounds) == 0);
+}
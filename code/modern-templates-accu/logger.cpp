@@ -0,0 +1,199 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "logger.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std::literals;
+
+namespace
+{
+#ifdef _WIN32
+    constexpr const char* null_device = "NUL";
+#else
+    constexpr const char* null_device = "/dev/null";
+#endif
+
+    // the sink runs on the background thread - the text is read after flush()
+    logging::Logger::Sink write_to(std::string& text)
+    {
+        return [&text](std::string_view lines) { text += lines; };
+    }
+}
+
+TEST_CASE("logger - format string parsed at compile time")
+{
+    using Format = logging::detail::ParsedFormat<"x = {}, y = {:.2f} {{}}">;
+
+    static_assert(Format::argument_count == 2);
+    static_assert(Format::pieces.size() == 6);
+    static_assert(Format::pieces[0].text == "x = " && Format::pieces[1].text == "{}" && Format::pieces[1].is_argument);
+    static_assert(Format::pieces[3].text == "{:.2f}");
+    static_assert(Format::pieces[4].text == " {" && Format::pieces[5].text == "}");
+
+    // logger.log<"{} {}">(1); // fails the build - the number of arguments does not match
+    // logger.log<"{:d}">("text"); // fails the build - the spec does not fit a string
+}
+
+TEST_CASE("logger - formatting on the background thread")
+{
+    std::string text;
+    logging::Logger logger{write_to(text)};
+
+    SECTION("arguments")
+    {
+        logger.log<"Hello">();
+        logger.log<"x = {}, y = {:.2f}, flag = {}">(42, 3.14159, true);
+        logger.log<"{{escaped}} {}">('c');
+        logger.flush();
+
+        REQUIRE(text == "Hello\nx = 42, y = 3.14, flag = true\n{escaped} c\n");
+    }
+
+    SECTION("strings are copied")
+    {
+        {
+            std::string name = "temporary";
+            logger.log<"name: {}, literal: {}, view: {}">(name, "abc", "xyz"sv);
+            name = "overwritten";
+        }
+        logger.flush();
+
+        REQUIRE(text == "name: temporary, literal: abc, view: xyz\n");
+    }
+}
+
+TEST_CASE("logger - a throwing sink does not stop the background thread")
+{
+    std::string text;
+    bool thrown = false;
+    logging::Logger logger{[&](std::string_view lines) {
+        if (!std::exchange(thrown, true))
+            throw std::runtime_error{"disk full"};
+        text += lines;
+    }};
+
+    logger.log<"lost">();
+    logger.flush();
+    logger.log<"kept">();
+    logger.flush();
+
+    REQUIRE(text == "kept\n");
+}
+
+TEST_CASE("logger - records wrap around a small ring")
+{
+    std::string text;
+    logging::Logger logger{write_to(text), 64};
+
+    std::string expected;
+    for (int i = 0; i < 1000; ++i)
+    {
+        logger.log<"#{} {}">(i, "abcdef"sv.substr(0, i % 7));
+        expected += fmt::format("#{} {}\n", i, "abcdef"sv.substr(0, i % 7));
+    }
+    logger.flush();
+
+    REQUIRE(text == expected);
+}
+
+TEST_CASE("logger - many threads")
+{
+    std::string text;
+
+    {
+        logging::Logger logger{write_to(text)};
+
+        std::vector<std::jthread> threads;
+        for (int id = 0; id < 4; ++id)
+            threads.emplace_back([&logger, id] {
+                for (int i = 0; i < 10'000; ++i)
+                    logger.log<"{} {}">(id, i);
+            });
+    } // threads are joined, then the logger drains the rings
+
+    std::vector<int> next(4, 0);
+    std::istringstream lines{text};
+    int id, i;
+    while (lines >> id >> i)
+        REQUIRE(i == next[id]++); // lines of a thread keep their order
+
+    REQUIRE(next == std::vector{10'000, 10'000, 10'000, 10'000});
+}
+
+TEST_CASE("logger - rings of exited threads are released")
+{
+    std::string text;
+    logging::Logger logger{write_to(text), 4096};
+
+    for (int id = 0; id < 100; ++id)
+        std::jthread{[&logger, id] { logger.log<"thread {}">(id); }};
+
+    const auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (logger.ring_count() > 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(1ms);
+
+    REQUIRE(logger.ring_count() == 0);
+
+    logger.flush();
+    REQUIRE(std::ranges::count(text, '\n') == 100);
+}
+
+TEST_CASE("logger - benchmarks", "[.][benchmark]")
+{
+    std::FILE* null_file = std::fopen(null_device, "w");
+    REQUIRE(null_file != nullptr);
+
+    std::ofstream null_stream{null_device};
+    auto* const cout_buffer = std::cout.rdbuf(null_stream.rdbuf());
+
+    logging::Logger logger{logging::Logger::write_to(null_file)};
+
+    const std::string_view name = "component";
+    const double value = 3.1415;
+
+    BENCHMARK("10'000 lines - std::cout <<")
+    {
+        for (int i = 0; i < 10'000; ++i)
+            std::cout << "message #" << i << " from " << name << " - value: " << value << '\n';
+    };
+
+    BENCHMARK("10'000 lines - fmt::print")
+    {
+        for (int i = 0; i < 10'000; ++i)
+            fmt::print(null_file, "message #{} from {} - value: {}\n", i, name, value);
+    };
+
+    BENCHMARK_ADVANCED("10'000 lines - Logger::log")(Catch::Benchmark::Chronometer meter)
+    {
+        logger.flush(); // every sample starts with empty rings - the caller's cost only
+
+        meter.measure([&] {
+            for (int i = 0; i < 10'000; ++i)
+                logger.log<"message #{} from {} - value: {}">(i, name, value);
+        });
+    };
+
+    BENCHMARK("10'000 lines - Logger::log + flush")
+    {
+        for (int i = 0; i < 10'000; ++i)
+            logger.log<"message #{} from {} - value: {}">(i, name, value);
+        logger.flush();
+    };
+
+    logger.flush();
+    std::cout.rdbuf(cout_buffer);
+    std::fclose(null_file);
+}
@@ -0,0 +1,554 @@
+#ifndef MODERN_TEMPLATES_LOGGER_HPP
+#define MODERN_TEMPLATES_LOGGER_HPP
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace logging
+{
+    //////////////////////////////////////////////////////////////////
+    // FormatString - format string literal as a template parameter (Str from templates.cpp)
+    //   logger.log<"tick {} from {}">(...) - the literal converts implicitly, N includes the terminating '\0'
+    template <std::size_t N>
+    struct FormatString
+    {
+        char chars[N];
+
+        constexpr FormatString(const char (&text)[N]) noexcept
+        {
+            std::copy_n(text, N, chars);
+        }
+
+        constexpr std::string_view view() const noexcept
+        {
+            return {chars, N - 1};
+        }
+    };
+
+    namespace detail
+    {
+        // literal text or a placeholder - "{}", "{:.3f}"
+        struct Piece
+        {
+            std::string_view text{""};
+            bool is_argument = false;
+        };
+
+        // splits the format into pieces - "{{" & "}}" end up as one-character literals
+        //   * only automatic indexing ({} or {:spec}) - a malformed format fails the build
+        template <typename Emit>
+        constexpr void parse_format(std::string_view format, Emit emit)
+        {
+            std::size_t literal_begin = 0;
+
+            for (std::size_t i = 0; i < format.size(); ++i)
+            {
+                if (format[i] != '{' && format[i] != '}')
+                    continue;
+
+                if (i + 1 < format.size() && format[i + 1] == format[i]) // escaped brace
+                {
+                    emit(Piece{format.substr(literal_begin, i + 1 - literal_begin)});
+                    literal_begin = ++i + 1;
+                    continue;
+                }
+
+                if (format[i] == '}')
+                    throw std::invalid_argument("unmatched '}' in format string");
+
+                const std::size_t end = format.find('}', i);
+                if (end == std::string_view::npos)
+                    throw std::invalid_argument("unmatched '{' in format string");
+                if (format[i + 1] != '}' && format[i + 1] != ':')
+                    throw std::invalid_argument("only automatic argument indexing is supported");
+
+                if (i > literal_begin)
+                    emit(Piece{format.substr(literal_begin, i - literal_begin)});
+                emit(Piece{format.substr(i, end + 1 - i), true});
+
+                i = end;
+                literal_begin = end + 1;
+            }
+
+            if (literal_begin < format.size())
+                emit(Piece{format.substr(literal_begin)});
+        }
+
+        template <FormatString Format>
+        struct ParsedFormat
+        {
+            static constexpr std::size_t piece_count = [] {
+                std::size_t count = 0;
+                parse_format(Format.view(), [&count](const Piece&) { ++count; });
+                return count;
+            }();
+
+            static constexpr std::array<Piece, piece_count> pieces = [] {
+                std::array<Piece, piece_count> result;
+                std::size_t i = 0;
+                parse_format(Format.view(), [&](const Piece& piece) { result[i++] = piece; });
+                return result;
+            }();
+
+            static constexpr std::size_t argument_count = std::ranges::count_if(pieces, &Piece::is_argument);
+        };
+
+        template <typename T>
+        concept StringLike = std::convertible_to<const T&, std::string_view>;
+
+        // strings are copied into the record, everything else is copied byte by byte
+        template <typename T>
+        concept Loggable = StringLike<T> || (std::is_trivially_copyable_v<T> && fmt::is_formattable<T>::value);
+
+        // type of the argument decoded on the background thread
+        template <typename T>
+        using Stored = std::conditional_t<StringLike<T>, std::string_view, std::decay_t<T>>;
+
+        //////////////////////////////////////////////////////////////////
+        // ByteRing - lock-free single producer, single consumer ring of bytes
+        //   * head & tail only grow - the position in the storage is masked
+        //   * records may wrap around the end of the storage
+        //   * the producer retires the ring after its last record - the consumer may drop it once drained
+        class ByteRing
+        {
+            std::unique_ptr<std::byte[]> storage_;
+            std::size_t mask_;
+
+            alignas(64) std::atomic<std::size_t> head_{0}; // published by the producer
+            std::size_t cached_tail_{0};                    // producer's last look at tail_
+
+            alignas(64) std::atomic<std::size_t> tail_{0}; // released by the consumer
+            std::atomic<bool> retired_{false};
+
+        public:
+            explicit ByteRing(std::size_t capacity)
+                : storage_{std::make_unique<std::byte[]>(std::bit_ceil(capacity))}
+                , mask_{std::bit_ceil(capacity) - 1}
+            {
+            }
+
+            std::size_t capacity() const noexcept
+            {
+                return mask_ + 1;
+            }
+
+            // producer - waits until size bytes are free & returns the position of the record
+            std::size_t reserve(std::size_t size)
+            {
+                if (size > capacity())
+                    throw std::length_error("log record does not fit in the ring buffer");
+
+                const std::size_t head = head_.load(std::memory_order_relaxed);
+                while (head + size - cached_tail_ > capacity())
+                {
+                    cached_tail_ = tail_.load(std::memory_order_acquire);
+                    if (head + size - cached_tail_ > capacity())
+                        std::this_thread::yield();
+                }
+                return head;
+            }
+
+            void publish(std::size_t head) noexcept
+            {
+                head_.store(head, std::memory_order_release);
+            }
+
+            void retire() noexcept
+            {
+                retired_.store(true, std::memory_order_release);
+            }
+
+            void write(std::size_t position, const void* data, std::size_t size) noexcept
+            {
+                const std::size_t offset = position & mask_;
+                const std::size_t first = std::min(size, capacity() - offset);
+                std::memcpy(storage_.get() + offset, data, first);
+                std::memcpy(storage_.get(), static_cast<const std::byte*>(data) + first, size - first);
+            }
+
+            // consumer
+            std::size_t head() const noexcept
+            {
+                return head_.load(std::memory_order_acquire);
+            }
+
+            std::size_t tail() const noexcept
+            {
+                return tail_.load(std::memory_order_acquire);
+            }
+
+            // no record is published after retired() returns true
+            bool retired() const noexcept
+            {
+                return retired_.load(std::memory_order_acquire);
+            }
+
+            void release(std::size_t tail) noexcept
+            {
+                tail_.store(tail, std::memory_order_release);
+            }
+
+            void read(std::size_t position, void* data, std::size_t size) const noexcept
+            {
+                const std::size_t offset = position & mask_;
+                const std::size_t first = std::min(size, capacity() - offset);
+                std::memcpy(data, storage_.get() + offset, first);
+                std::memcpy(static_cast<std::byte*>(data) + first, storage_.get(), size - first);
+            }
+        };
+
+        using DecodeFn = void (*)(const std::byte* payload, fmt::memory_buffer& out);
+
+        struct RecordHeader
+        {
+            DecodeFn decode;
+            std::size_t payload_size;
+        };
+
+        class Writer
+        {
+            ByteRing& ring_;
+            std::size_t position_;
+
+        public:
+            Writer(ByteRing& ring, std::size_t position) noexcept
+                : ring_{ring}
+                , position_{position}
+            {
+            }
+
+            std::size_t position() const noexcept
+            {
+                return position_;
+            }
+
+            void put(const void* data, std::size_t size) noexcept
+            {
+                ring_.write(position_, data, size);
+                position_ += size;
+            }
+
+            template <typename T>
+            void put(const T& value) noexcept
+            {
+                put(&value, sizeof(T));
+            }
+        };
+
+        class Reader
+        {
+            const std::byte* data_;
+
+        public:
+            explicit Reader(const std::byte* data) noexcept
+                : data_{data}
+            {
+            }
+
+            template <typename T>
+            T get() noexcept
+            {
+                if constexpr (std::is_same_v<T, std::string_view>)
+                {
+                    const auto size = get<std::size_t>();
+                    const std::string_view text{reinterpret_cast<const char*>(data_), size};
+                    data_ += size;
+                    return text;
+                }
+                else
+                {
+                    std::array<std::byte, sizeof(T)> bytes;
+                    std::memcpy(bytes.data(), data_, sizeof(T));
+                    data_ += sizeof(T);
+                    return std::bit_cast<T>(bytes);
+                }
+            }
+        };
+
+        template <typename T>
+        std::size_t encoded_size(const T& arg) noexcept
+        {
+            if constexpr (StringLike<T>)
+                return sizeof(std::size_t) + std::string_view{arg}.size();
+            else
+                return sizeof(T);
+        }
+
+        template <typename T>
+        void encode(Writer& writer, const T& arg) noexcept
+        {
+            if constexpr (StringLike<T>)
+            {
+                const std::string_view text{arg};
+                writer.put(text.size());
+                writer.put(text.data(), text.size());
+            }
+            else
+                writer.put(arg);
+        }
+
+        template <typename T>
+        void format_argument(fmt::memory_buffer& out, std::string_view placeholder, const T& arg)
+        {
+            if (placeholder.size() == 2)
+                fmt::format_to(std::back_inserter(out), "{}", arg);
+            else
+                fmt::format_to(std::back_inserter(out), fmt::runtime(placeholder), arg);
+        }
+
+        // runs on the background thread - one instance per format string & argument types
+        template <FormatString Format, typename... Args>
+        void decode(const std::byte* payload, fmt::memory_buffer& out)
+        {
+            Reader reader{payload};
+            const std::tuple<Args...> args{reader.get<Args>()...}; // braced init - decoded left to right
+
+            constexpr auto& pieces = ParsedFormat<Format>::pieces;
+            std::size_t piece = 0;
+            const auto append_literals = [&] {
+                for (; piece < pieces.size() && !pieces[piece].is_argument; ++piece)
+                    out.append(pieces[piece].text.data(), pieces[piece].text.data() + pieces[piece].text.size());
+            };
+
+            std::apply([&](const auto&... arg) { ((append_literals(), format_argument(out, pieces[piece++].text, arg)), ...); }, args);
+            append_literals();
+            out.push_back('\n');
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // Logger - the caller copies raw arguments, a background thread formats them
+    //   logger.log<"tick {} from {}">(id, name);
+    //   * the format string is parsed & checked against the number & types of arguments at compile time
+    //   * a record that cannot be formatted or a throwing sink is reported - the background thread keeps running
+    //   * every thread writes to its own lock-free ring - logging takes no lock,
+    //     the ring is released once its thread has exited & the records are written
+    //   * strings are copied (they may not outlive the call), other arguments have to be trivially copyable
+    //   * a full ring makes the caller wait for the background thread - no record is lost
+    //   * the sink gets batches of formatted lines on the background thread
+    class Logger
+    {
+    public:
+        using Sink = std::function<void(std::string_view)>;
+
+        static constexpr std::size_t default_ring_capacity = 1 << 20;
+
+        static Sink write_to(std::FILE* file)
+        {
+            return [file](std::string_view lines) { std::fwrite(lines.data(), 1, lines.size(), file); };
+        }
+
+        explicit Logger(Sink sink = write_to(stdout), std::size_t ring_capacity = default_ring_capacity)
+            : sink_{std::move(sink)}
+            , ring_capacity_{ring_capacity}
+            , worker_{[this](std::stop_token stop) { run(stop); }}
+        {
+        }
+
+        Logger(const Logger&) = delete;
+        Logger& operator=(const Logger&) = delete;
+
+        template <FormatString Format, detail::Loggable... Args>
+        void log(const Args&... args)
+        {
+            static_assert(detail::ParsedFormat<Format>::argument_count == sizeof...(Args),
+                "number of placeholders in the format string does not match the number of arguments");
+
+            // fmt checks every spec against the type formatted on the background thread - "{:d}" for a string fails the build
+            [[maybe_unused]] constexpr fmt::format_string<detail::Stored<Args>...> checked_format{Format.view()};
+
+            const std::size_t payload_size = (std::size_t{0} + ... + detail::encoded_size(args));
+
+            detail::ByteRing& ring = thread_ring();
+            detail::Writer writer{ring, ring.reserve(sizeof(detail::RecordHeader) + payload_size)};
+            writer.put(detail::RecordHeader{&detail::decode<Format, detail::Stored<Args>...>, payload_size});
+            (detail::encode(writer, args), ...);
+            ring.publish(writer.position());
+        }
+
+        // waits until everything logged before the call has reached the sink
+        void flush() const
+        {
+            std::vector<std::pair<std::shared_ptr<detail::ByteRing>, std::size_t>> pending;
+            {
+                std::lock_guard lk{rings_mtx_};
+                for (const auto& ring : rings_)
+                    pending.emplace_back(ring, ring->head());
+            }
+
+            for (const auto& [ring, head] : pending)
+                while (ring->tail() < head)
+                    std::this_thread::yield();
+        }
+
+        // number of rings - one per thread that has logged, minus the drained rings of exited threads
+        std::size_t ring_count() const
+        {
+            std::lock_guard lk{rings_mtx_};
+            return rings_.size();
+        }
+
+    private:
+        static constexpr auto idle_wait = std::chrono::microseconds{100};
+
+        // entry of the thread_local list of rings - retires the ring when the thread exits
+        struct ThreadRing
+        {
+            std::uint64_t logger_id;
+            detail::ByteRing* ring;
+            std::weak_ptr<detail::ByteRing> owner; // expires with the logger
+
+            ThreadRing(std::uint64_t logger_id, const std::shared_ptr<detail::ByteRing>& ring) noexcept
+                : logger_id{logger_id}
+                , ring{ring.get()}
+                , owner{ring}
+            {
+            }
+
+            ThreadRing(ThreadRing&&) noexcept = default;
+            ThreadRing& operator=(ThreadRing&&) noexcept = default;
+
+            ~ThreadRing()
+            {
+                if (const auto alive = owner.lock())
+                    alive->retire();
+            }
+        };
+
+        inline static std::atomic<std::uint64_t> next_id_{0};
+
+        const std::uint64_t id_ = next_id_++; // ids are not reused - a new logger at the same address gets new rings
+        Sink sink_;
+        std::size_t ring_capacity_;
+        mutable std::mutex rings_mtx_;
+        std::vector<std::shared_ptr<detail::ByteRing>> rings_; // retired rings are removed by the background thread
+        std::atomic<bool> rings_added_{false};
+        std::jthread worker_; // the last member - stopped & joined first
+
+        detail::ByteRing& thread_ring()
+        {
+            thread_local std::vector<ThreadRing> thread_rings; // rings of this thread - one per logger
+
+            for (const auto& entry : thread_rings)
+                if (entry.logger_id == id_)
+                    return *entry.ring;
+
+            std::erase_if(thread_rings, [](const ThreadRing& entry) { return entry.owner.expired(); }); // rings of destroyed loggers
+
+            auto ring = std::make_shared<detail::ByteRing>(ring_capacity_);
+            {
+                std::lock_guard lk{rings_mtx_};
+                rings_.push_back(ring);
+                rings_added_.store(true, std::memory_order_release);
+            }
+            thread_rings.emplace_back(id_, ring);
+
+            return *ring;
+        }
+
+        void run(std::stop_token stop)
+        {
+            fmt::memory_buffer out;
+            std::vector<std::byte> payload;
+            std::vector<std::shared_ptr<detail::ByteRing>> rings;
+
+            for (;;)
+            {
+                const bool stopping = stop.stop_requested(); // the drain after the request sees every record logged before it
+
+                if (rings_added_.exchange(false, std::memory_order_acquire))
+                {
+                    std::lock_guard lk{rings_mtx_};
+                    rings = rings_;
+                }
+
+                bool drained_any = false;
+                bool any_retired = false;
+                for (const auto& ring : rings)
+                {
+                    const bool retired = ring->retired(); // checked first - the drain below then reads the last record
+                    drained_any |= drain(*ring, out, payload);
+                    any_retired |= retired;
+                }
+
+                if (any_retired) // rings of exited threads are drained - they are dropped
+                {
+                    std::lock_guard lk{rings_mtx_};
+                    std::erase_if(rings_, [](const auto& ring) { return ring->retired() && ring->tail() == ring->head(); });
+                    rings = rings_;
+                }
+
+                if (!drained_any)
+                {
+                    if (stopping)
+                        return;
+                    std::this_thread::sleep_for(idle_wait);
+                }
+            }
+        }
+
+        bool drain(detail::ByteRing& ring, fmt::memory_buffer& out, std::vector<std::byte>& payload)
+        {
+            std::size_t tail = ring.tail();
+            const std::size_t head = ring.head();
+            if (tail == head)
+                return false;
+
+            while (tail != head)
+            {
+                detail::RecordHeader header;
+                ring.read(tail, &header, sizeof(header));
+                payload.resize(header.payload_size);
+                ring.read(tail + sizeof(header), payload.data(), header.payload_size);
+
+                const std::size_t line_begin = out.size();
+                try
+                {
+                    header.decode(payload.data(), out);
+                }
+                catch (const std::exception& e) // an exception must not stop the background thread - the line is replaced
+                {
+                    out.resize(line_begin);
+                    fmt::format_to(std::back_inserter(out), "<log record not formatted: {}>\n", e.what());
+                }
+                tail += sizeof(header) + header.payload_size;
+            }
+
+            try
+            {
+                sink_({out.data(), out.size()});
+            }
+            catch (...)
+            {
+                std::fputs("<logger sink failed - lines dropped>\n", stderr);
+            }
+            out.clear();
+            ring.release(tail);
+
+            return true;
+        }
+    };
+}
+
+#endif //MODERN_TEMPLATES_LOGGER_HPP
@@ -0,0 +1,129 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "anagram_index.hpp"
+#include "helpers.hpp"
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std::literals;
+
+namespace rngs = std::ranges;
+
+TEST_CASE("letter signature")
+{
+    using word_index::make_signature;
+
+    SECTION("order of letters does not matter")
+    {
+        static_assert(make_signature("listen") == make_signature("silent"));
+        static_assert(make_signature("listen") != make_signature("listens"));
+    }
+
+    SECTION("case and non-letters are ignored")
+    {
+        REQUIRE(make_signature("Ethic's") == make_signature("ethics"));
+    }
+
+    SECTION("saturated counters are flagged")
+    {
+        REQUIRE_FALSE(make_signature(std::string(15, 'z')).is_saturated());
+        REQUIRE(make_signature(std::string(16, 'z')).is_saturated());
+    }
+}
+
+TEST_CASE("anagram index")
+{
+    const std::vector<std::string> words = {"listen", "stone", "silent", "tones", "enlist", "notes", "abc", "onset", "tinsel"};
+
+    word_index::AnagramIndex index{words, 3};
+
+    REQUIRE(index.size() == words.size());
+    REQUIRE(index.group_count() == 3);
+
+    SECTION("lookup returns a group of words")
+    {
+        auto group = index.find("inlets");
+
+        std::vector<std::string_view> result(group.begin(), group.end());
+        rngs::sort(result);
+
+        REQUIRE(result == std::vector{"enlist"sv, "listen"sv, "silent"sv, "tinsel"sv});
+    }
+
+    SECTION("missing signature")
+    {
+        REQUIRE(index.find("xyz").empty());
+        REQUIRE(word_index::AnagramIndex{}.find("abc").empty());
+    }
+
+    SECTION("saturated signatures are verified")
+    {
+        const std::vector<std::string> long_words = {std::string(16, 'a'), std::string(17, 'a')};
+        word_index::AnagramIndex long_index{long_words};
+
+        REQUIRE(long_index.find(std::string(18, 'a')).size() == 2);
+        REQUIRE(long_index.anagrams(std::string(17, 'a')) == std::vector{std::string_view{long_words[1]}});
+    }
+}
+
+TEST_CASE("anagram index - dictionary")
+{
+    const std::vector<std::string> dictionary = helpers::load_dictionary();
+
+    word_index::AnagramIndex index{dictionary};
+
+    REQUIRE(index.size() == dictionary.size());
+
+    auto group = index.find("tinsel");
+    REQUIRE(rngs::find(group, "listen"sv) != group.end());
+    REQUIRE(rngs::find(group, "silent"sv) != group.end());
+    REQUIRE(rngs::all_of(group, [](std::string_view w) { return word_index::same_letters(w, "tinsel"); }));
+}
+
+TEST_CASE("anagram index - benchmarks", "[.][benchmark]")
+{
+    const std::vector<std::string> dictionary = helpers::load_dictionary();
+
+    BENCHMARK("build - 1 thread")
+    {
+        return word_index::AnagramIndex{dictionary, 1};
+    };
+
+    BENCHMARK("build - hardware concurrency")
+    {
+        return word_index::AnagramIndex{dictionary};
+    };
+
+    word_index::AnagramIndex index{dictionary};
+
+    std::unordered_map<std::string, std::vector<std::string_view>> node_index;
+    for (const auto& word : dictionary)
+    {
+        std::string key = word;
+        rngs::sort(key);
+        node_index[key].push_back(word);
+    }
+
+    BENCHMARK("lookup - flat signature table")
+    {
+        size_t count{};
+        for (size_t i = 0; i < dictionary.size(); i += 16)
+            count += index.find(dictionary[i]).size();
+        return count;
+    };
+
+    BENCHMARK("lookup - unordered_map with sorted letters")
+    {
+        size_t count{};
+        for (size_t i = 0; i < dictionary.size(); i += 16)
+        {
+            std::string key = dictionary[i];
+            rngs::sort(key);
+            count += node_index.find(key)->second.size();
+        }
+        return count;
+    };
+}
@@ -0,0 +1,275 @@
+#ifndef RANGES_ANAGRAM_INDEX_HPP
+#define RANGES_ANAGRAM_INDEX_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <future>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace word_index
+{
+    //////////////////////////////////////////////////////////////////
+    // letter signature - 26 letter counts packed into a 128-bit key
+    //   * lo: 4-bit counters for letters a..p
+    //   * hi: 4-bit counters for letters q..z
+    //   * top bit of hi is set when any counter saturated (> 15)
+    // non-letters are ignored and letters are case-folded
+    struct Signature
+    {
+        std::uint64_t lo{};
+        std::uint64_t hi{};
+
+        static constexpr std::uint64_t saturated_flag = 1ull << 63;
+
+        bool is_saturated() const
+        {
+            return hi & saturated_flag;
+        }
+
+        bool operator==(const Signature&) const = default;
+        auto operator<=>(const Signature&) const = default;
+    };
+
+    constexpr Signature make_signature(std::string_view word)
+    {
+        Signature sig{};
+
+        for (char c : word)
+        {
+            if (c >= 'A' && c <= 'Z')
+                c = static_cast<char>(c - 'A' + 'a');
+
+            if (c < 'a' || c > 'z')
+                continue;
+
+            const int letter = c - 'a';
+            std::uint64_t& half = letter < 16 ? sig.lo : sig.hi;
+            const int shift = (letter % 16) * 4;
+
+            if (((half >> shift) & 0xF) == 0xF)
+                sig.hi |= Signature::saturated_flag;
+            else
+                half += 1ull << shift;
+        }
+
+        return sig;
+    }
+
+    inline std::size_t hash_value(const Signature& sig)
+    {
+        // 128 -> 64 bit mix
+        std::uint64_t h = sig.lo * 0x9E3779B97F4A7C15ull ^ std::rotl(sig.hi * 0xC2B2AE3D27D4EB4Full, 31);
+        h ^= h >> 29;
+        h *= 0xBF58476D1CE4E5B9ull;
+        return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+
+    inline bool same_letters(std::string_view a, std::string_view b)
+    {
+        auto letters = [](std::string_view word) {
+            std::string folded;
+            for (char c : word)
+            {
+                if (c >= 'A' && c <= 'Z')
+                    folded.push_back(static_cast<char>(c - 'A' + 'a'));
+                else if (c >= 'a' && c <= 'z')
+                    folded.push_back(c);
+            }
+            std::ranges::sort(folded);
+            return folded;
+        };
+
+        return letters(a) == letters(b);
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // anagram index - signature -> words with the same letters
+    //   * words are copied into one contiguous buffer grouped by signature
+    //   * lookup uses a flat open-addressing table (linear probing)
+    //   * signatures are computed & sorted in parallel over chunks of the input
+    class AnagramIndex
+    {
+        struct Slot
+        {
+            Signature signature;
+            std::uint32_t offset;
+            std::uint32_t count; // 0 - empty slot
+        };
+
+        std::vector<char> chars_; // words_ point into this buffer - it is moved but never copied
+        std::vector<std::string_view> words_;
+        std::vector<Slot> slots_;
+        std::size_t mask_{};
+
+        using Entry = std::pair<Signature, std::uint32_t>;
+
+        static std::vector<Entry> sorted_signatures(std::span<const std::string> dictionary, std::size_t concurrency)
+        {
+            const std::size_t chunk_count = std::clamp<std::size_t>(concurrency, 1, std::max<std::size_t>(dictionary.size(), 1));
+            const std::size_t chunk_size = (dictionary.size() + chunk_count - 1) / chunk_count;
+
+            std::vector<Entry> entries(dictionary.size());
+            std::vector<std::future<void>> chunks;
+            std::vector<std::size_t> bounds{0};
+
+            for (std::size_t first = 0; first < dictionary.size(); first += chunk_size)
+            {
+                const std::size_t last = std::min(first + chunk_size, dictionary.size());
+                bounds.push_back(last);
+
+                chunks.push_back(std::async(std::launch::async, [&, first, last] {
+                    for (std::size_t i = first; i < last; ++i)
+                        entries[i] = Entry{make_signature(dictionary[i]), static_cast<std::uint32_t>(i)};
+                    std::sort(entries.begin() + first, entries.begin() + last);
+                }));
+            }
+
+            for (auto& chunk : chunks)
+                chunk.get();
+
+            // pairwise merge of the sorted runs - every level in parallel
+            while (bounds.size() > 2)
+            {
+                std::vector<std::future<void>> merges;
+                std::vector<std::size_t> merged_bounds{0};
+
+                for (std::size_t i = 0; i + 1 < bounds.size(); i += 2)
+                {
+                    const std::size_t first = bounds[i];
+                    const std::size_t middle = bounds[i + 1];
+                    const std::size_t last = i + 2 < bounds.size() ? bounds[i + 2] : middle;
+                    merged_bounds.push_back(last);
+
+                    if (middle != last)
+                    {
+                        merges.push_back(std::async(std::launch::async, [&entries, first, middle, last] {
+                            std::inplace_merge(entries.begin() + first, entries.begin() + middle, entries.begin() + last);
+                        }));
+                    }
+                }
+
+                for (auto& merge : merges)
+                    merge.get();
+
+                bounds = std::move(merged_bounds);
+            }
+
+            return entries;
+        }
+
+        const Slot* find_slot(const Signature& signature) const
+        {
+            if (slots_.empty())
+                return nullptr;
+
+            for (std::size_t pos = hash_value(signature) & mask_;; pos = (pos + 1) & mask_)
+            {
+                const Slot& slot = slots_[pos];
+
+                if (slot.count == 0)
+                    return nullptr;
+
+                if (slot.signature == signature)
+                    return &slot;
+            }
+        }
+
+    public:
+        AnagramIndex() = default;
+
+        explicit AnagramIndex(std::span<const std::string> dictionary,
+            std::size_t concurrency = std::max(1u, std::thread::hardware_concurrency()))
+        {
+            const std::vector<Entry> entries = sorted_signatures(dictionary, concurrency);
+
+            std::size_t total_length = 0;
+            for (const auto& word : dictionary)
+                total_length += word.size();
+
+            chars_.reserve(total_length);
+            for (const auto& [signature, index] : entries)
+                chars_.insert(chars_.end(), dictionary[index].begin(), dictionary[index].end());
+
+            words_.reserve(entries.size());
+            std::size_t group_count = 0;
+            for (std::size_t i = 0, pos = 0; i < entries.size(); ++i)
+            {
+                const std::size_t length = dictionary[entries[i].second].size();
+                words_.emplace_back(chars_.data() + pos, length);
+                pos += length;
+
+                if (i == 0 || entries[i].first != entries[i - 1].first)
+                    ++group_count;
+            }
+
+            slots_.resize(std::bit_ceil(std::max<std::size_t>(group_count * 2, 16)));
+            mask_ = slots_.size() - 1;
+
+            for (std::size_t first = 0; first < entries.size();)
+            {
+                std::size_t last = first + 1;
+                while (last < entries.size() && entries[last].first == entries[first].first)
+                    ++last;
+
+                std::size_t pos = hash_value(entries[first].first) & mask_;
+                while (slots_[pos].count != 0)
+                    pos = (pos + 1) & mask_;
+
+                slots_[pos] = Slot{entries[first].first, static_cast<std::uint32_t>(first), static_cast<std::uint32_t>(last - first)};
+
+                first = last;
+            }
+        }
+
+        AnagramIndex(const AnagramIndex&) = delete;
+        AnagramIndex& operator=(const AnagramIndex&) = delete;
+        AnagramIndex(AnagramIndex&&) = default;
+        AnagramIndex& operator=(AnagramIndex&&) = default;
+
+        // all words built from the same letters as word (word itself included if present)
+        // - span is empty when there are no such words
+        std::span<const std::string_view> find(std::string_view word) const
+        {
+            const Signature signature = make_signature(word);
+            const Slot* slot = find_slot(signature);
+
+            if (!slot)
+                return {};
+
+            return std::span{words_}.subspan(slot->offset, slot->count);
+        }
+
+        // exact anagrams - filters out collisions of saturated signatures (very long words)
+        std::vector<std::string_view> anagrams(std::string_view word) const
+        {
+            auto group = find(word);
+
+            if (!make_signature(word).is_saturated())
+                return {group.begin(), group.end()};
+
+            std::vector<std::string_view> result;
+            std::ranges::copy_if(group, std::back_inserter(result), [word](std::string_view w) { return same_letters(w, word); });
+            return result;
+        }
+
+        std::size_t size() const
+        {
+            return words_.size();
+        }
+
+        std::size_t group_count() const
+        {
+            return std::ranges::count_if(slots_, [](const Slot& s) { return s.count != 0; });
+        }
+    };
+}
+
+#endif //RANGES_ANAGRAM_INDEX_HPP
@@ -0,0 +1,126 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "bloom_filter.hpp"
+#include "helpers.hpp"
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace rngs = std::ranges;
+
+namespace
+{
+    struct Id
+    {
+        int value;
+
+        bool operator==(const Id&) const = default;
+    };
+}
+
+namespace std
+{
+    template <>
+    struct hash<Id>
+    {
+        size_t operator()(const Id& id) const noexcept
+        {
+            return std::hash<int>{}(id.value);
+        }
+    };
+}
+
+namespace
+{
+    std::vector<std::string> non_words(size_t count)
+    {
+        std::vector<std::string> words;
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::string word = std::to_string(i);
+            word.insert(0, 1, '#');
+            words.push_back(std::move(word));
+        }
+        return words;
+    }
+}
+
+TEST_CASE("bloom filter")
+{
+    SECTION("no false negatives")
+    {
+        bloom::BloomFilter<int> filter{1024};
+
+        for (int i = 0; i < 100; ++i)
+            filter.insert(i * 7);
+
+        for (int i = 0; i < 100; ++i)
+            REQUIRE(filter.possibly_contains(i * 7));
+    }
+
+    SECTION("size is rounded to whole blocks")
+    {
+        bloom::BloomFilter<int> filter{1000, 3};
+
+        REQUIRE(filter.bit_count() == 1024);
+        REQUIRE(filter.hash_count() == 3);
+    }
+
+    SECTION("hash_value() is used through std::hash specialization")
+    {
+        static_assert(bloom::Hashable<Id>);
+
+        std::vector ids = {Id{1}, Id{42}, Id{665}};
+
+        auto filter = ids | bloom::to_bloom_filter(4096);
+
+        REQUIRE(rngs::all_of(ids, [&](Id id) { return filter.possibly_contains(id); }));
+        REQUIRE_FALSE(filter.possibly_contains(Id{7}));
+    }
+}
+
+TEST_CASE("bloom filter - dictionary")
+{
+    const std::vector<std::string> dictionary = helpers::load_dictionary();
+
+    auto filter = dictionary | bloom::to_bloom_filter(dictionary.size() * 16);
+
+    static_assert(std::is_same_v<decltype(filter), bloom::BloomFilter<std::string>>);
+
+    REQUIRE(rngs::all_of(dictionary, [&](const std::string& word) { return filter.possibly_contains(word); }));
+
+    const auto rejected = rngs::count_if(non_words(100'000), [&](const std::string& word) { return !filter.possibly_contains(word); });
+    REQUIRE(rejected > 99'000); // less than 1% of false positives
+}
+
+TEST_CASE("bloom filter - benchmarks", "[.][benchmark]")
+{
+    const std::vector<std::string> dictionary = helpers::load_dictionary();
+    const std::vector<std::string> queries = non_words(dictionary.size());
+
+    BENCHMARK("build - split-block bloom filter")
+    {
+        return dictionary | bloom::to_bloom_filter(dictionary.size() * 16);
+    };
+
+    BENCHMARK("build - unordered_set")
+    {
+        return std::unordered_set<std::string>(dictionary.begin(), dictionary.end());
+    };
+
+    auto filter = dictionary | bloom::to_bloom_filter(dictionary.size() * 16);
+    std::unordered_set<std::string> words(dictionary.begin(), dictionary.end());
+
+    BENCHMARK("reject non-words - split-block bloom filter")
+    {
+        return rngs::count_if(queries, [&](const std::string& word) { return filter.possibly_contains(word); });
+    };
+
+    BENCHMARK("reject non-words - unordered_set")
+    {
+        return rngs::count_if(queries, [&](const std::string& word) { return words.contains(word); });
+    };
+}
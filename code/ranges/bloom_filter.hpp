@@ -0,0 +1,144 @@
+#ifndef RANGES_BLOOM_FILTER_HPP
+#define RANGES_BLOOM_FILTER_HPP
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <ranges>
+#include <vector>
+
+namespace bloom
+{
+    template <typename T>
+    concept Hashable = requires(T a) {
+        { std::hash<T>{}(a) } -> std::convertible_to<std::size_t>;
+    };
+
+    //////////////////////////////////////////////////////////////////
+    // split-block Bloom filter
+    //   * filter is an array of 256-bit blocks (8 x 32-bit lanes) aligned to 32 bytes
+    //   * a key touches exactly one block - one cache line per insert/probe
+    //   * every hash function sets one bit in its own lane - the 8-lane
+    //     loops below are written to be auto-vectorized (SSE/AVX/NEON)
+    template <Hashable T>
+    class BloomFilter
+    {
+    public:
+        static constexpr std::size_t lanes = 8;
+        static constexpr std::size_t block_bits = lanes * 32;
+
+    private:
+        struct alignas(32) Block
+        {
+            std::array<std::uint32_t, lanes> words{};
+        };
+
+        static constexpr std::array<std::uint32_t, lanes> salts = {
+            0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+        std::vector<Block> blocks_;
+        std::uint32_t hash_count_;
+
+        static std::uint64_t mix(std::uint64_t h)
+        {
+            // std::hash may be an identity for integral types
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        std::array<std::uint32_t, lanes> make_mask(std::uint32_t key) const
+        {
+            std::array<std::uint32_t, lanes> mask;
+            for (std::size_t i = 0; i < lanes; ++i)
+                mask[i] = i < hash_count_ ? 1u << ((key * salts[i]) >> 27) : 0u;
+            return mask;
+        }
+
+        Block& block_for(std::uint64_t h)
+        {
+            return blocks_[((h >> 32) * blocks_.size()) >> 32];
+        }
+
+        const Block& block_for(std::uint64_t h) const
+        {
+            return blocks_[((h >> 32) * blocks_.size()) >> 32];
+        }
+
+    public:
+        // bits - requested size of the filter (rounded up to whole blocks)
+        // hash_count - number of bits set per key (1 - 8)
+        explicit BloomFilter(std::size_t bits, std::size_t hash_count = lanes)
+            : blocks_(std::max<std::size_t>((bits + block_bits - 1) / block_bits, 1))
+            , hash_count_{static_cast<std::uint32_t>(std::clamp<std::size_t>(hash_count, 1, lanes))}
+        {
+        }
+
+        std::size_t bit_count() const
+        {
+            return blocks_.size() * block_bits;
+        }
+
+        std::size_t hash_count() const
+        {
+            return hash_count_;
+        }
+
+        void insert(const T& item)
+        {
+            const std::uint64_t h = mix(std::hash<T>{}(item));
+            const auto mask = make_mask(static_cast<std::uint32_t>(h));
+            Block& block = block_for(h);
+
+            for (std::size_t i = 0; i < lanes; ++i)
+                block.words[i] |= mask[i];
+        }
+
+        // false - item was never inserted; true - item was probably inserted
+        bool possibly_contains(const T& item) const
+        {
+            const std::uint64_t h = mix(std::hash<T>{}(item));
+            const auto mask = make_mask(static_cast<std::uint32_t>(h));
+            const Block& block = block_for(h);
+
+            std::uint32_t missing = 0;
+            for (std::size_t i = 0; i < lanes; ++i)
+                missing |= mask[i] & ~block.words[i];
+
+            return missing == 0;
+        }
+    };
+
+    //////////////////////////////////////////////////////////////////
+    // range -> BloomFilter conversion
+    //   auto filter = words | bloom::to_bloom_filter(1 << 20);
+    struct ToBloomFilterFn
+    {
+        std::size_t bits;
+        std::size_t hash_count = BloomFilter<int>::lanes;
+    };
+
+    inline ToBloomFilterFn to_bloom_filter(std::size_t bits, std::size_t hash_count = BloomFilter<int>::lanes)
+    {
+        return ToBloomFilterFn{bits, hash_count};
+    }
+
+    template <std::ranges::input_range TRange>
+        requires Hashable<std::ranges::range_value_t<TRange>>
+    auto operator|(TRange&& rng, ToBloomFilterFn params)
+    {
+        BloomFilter<std::ranges::range_value_t<TRange>> filter{params.bits, params.hash_count};
+
+        for (auto&& item : rng)
+            filter.insert(item);
+
+        return filter;
+    }
+}
+
+#endif //RANGES_BLOOM_FILTER_HPP
@@ -0,0 +1,158 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+#include "fuzzy_search.hpp"
+#include "helpers.hpp"
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::literals;
+
+namespace rngs = std::ranges;
+
+namespace
+{
+    std::vector<fuzzy::BkTree::Match> linear_scan(const std::vector<std::string>& dictionary, std::string_view query, size_t max_distance)
+    {
+        std::vector<fuzzy::BkTree::Match> matches;
+        for (const auto& word : dictionary)
+        {
+            const size_t d = fuzzy::levenshtein_distance(query, word);
+            if (d <= max_distance)
+                matches.push_back({word, d});
+        }
+        return matches;
+    }
+
+    auto sorted(std::vector<fuzzy::BkTree::Match> matches)
+    {
+        rngs::sort(matches, {}, &fuzzy::BkTree::Match::word);
+        return matches;
+    }
+}
+
+TEST_CASE("edit distance")
+{
+    SECTION("known distances")
+    {
+        REQUIRE(fuzzy::edit_distance("kitten", "sitting") == 3);
+        REQUIRE(fuzzy::edit_distance("flaw", "lawn") == 2);
+        REQUIRE(fuzzy::edit_distance("", "abc") == 3);
+        REQUIRE(fuzzy::edit_distance("abc", "") == 3);
+        REQUIRE(fuzzy::edit_distance("same", "same") == 0);
+    }
+
+    SECTION("bit-parallel kernel matches dynamic programming")
+    {
+        std::mt19937 rnd_gen{42};
+        std::uniform_int_distribution<size_t> length(0, 70);
+        std::uniform_int_distribution<int> letter('a', 'd');
+
+        auto random_word = [&] {
+            std::string word(length(rnd_gen), ' ');
+            rngs::generate(word, [&] { return static_cast<char>(letter(rnd_gen)); });
+            return word;
+        };
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            const std::string a = random_word();
+            const std::string b = random_word();
+
+            REQUIRE(fuzzy::edit_distance(a, b) == fuzzy::levenshtein_distance(a, b));
+        }
+    }
+}
+
+TEST_CASE("BK-tree")
+{
+    const std::vector<std::string> words = {"book", "books", "cake", "boo", "boon", "cook", "cape", "cart", "book"};
+
+    fuzzy::BkTree tree{words};
+
+    REQUIRE(tree.size() == 8); // duplicates are skipped
+
+    SECTION("exact match")
+    {
+        REQUIRE(tree.find("cake", 0) == std::vector{fuzzy::BkTree::Match{"cake", 0}});
+    }
+
+    SECTION("matches within distance")
+    {
+        auto matches = sorted(tree.find("bork", 1));
+
+        REQUIRE(matches == std::vector<fuzzy::BkTree::Match>{{"book", 1}});
+
+        REQUIRE(sorted(tree.find("caqe", 1)) == std::vector<fuzzy::BkTree::Match>{{"cake", 1}, {"cape", 1}});
+    }
+
+    SECTION("empty tree")
+    {
+        REQUIRE(fuzzy::BkTree{}.find("abc", 3).empty());
+    }
+}
+
+TEST_CASE("BK-tree - dictionary")
+{
+    const std::vector<std::string> dictionary = helpers::load_dictionary();
+
+    fuzzy::BkTree tree{dictionary};
+
+    for (auto query : {"speling"sv, "xylophon"sv})
+    {
+        const auto expected = sorted(linear_scan(dictionary, query, 2));
+
+        REQUIRE(sorted(tree.find(query, 2)) == expected);
+
+        std::vector<fuzzy::BkTree::Match> expected_k1;
+        rngs::copy_if(expected, std::back_inserter(expected_k1), [](const auto& m) { return m.distance <= 1; });
+
+        REQUIRE(sorted(tree.find(query, 1)) == expected_k1);
+    }
+}
+
+TEST_CASE("BK-tree - benchmarks", "[.][benchmark]")
+{
+    const std::vector<std::string> dictionary = helpers::load_dictionary();
+    const std::vector<std::string> queries = {"speling", "dictionery", "xylophon", "recieve", "ocurence", "tomorow", "begining", "wierd"};
+
+    fuzzy::BkTree tree{dictionary};
+
+    BENCHMARK("build BK-tree")
+    {
+        return fuzzy::BkTree{dictionary};
+    };
+
+    for (size_t k : {1, 2, 3})
+    {
+        BENCHMARK("k = " + std::to_string(k) + " - linear scan (DP) - " + std::to_string(queries.size()) + " queries")
+        {
+            size_t count{};
+            for (const auto& query : queries)
+                count += linear_scan(dictionary, query, k).size();
+            return count;
+        };
+
+        BENCHMARK("k = " + std::to_string(k) + " - linear scan (bit-parallel) - " + std::to_string(queries.size()) + " queries")
+        {
+            size_t count{};
+            for (const auto& query : queries)
+            {
+                const fuzzy::BitParallelPattern pattern{query};
+                count += rngs::count_if(dictionary, [&](const std::string& word) { return pattern.distance(word) <= k; });
+            }
+            return count;
+        };
+
+        BENCHMARK("k = " + std::to_string(k) + " - BK-tree - " + std::to_string(queries.size()) + " queries")
+        {
+            size_t count{};
+            for (const auto& query : queries)
+                count += tree.find(query, k).size();
+            return count;
+        };
+    }
+}
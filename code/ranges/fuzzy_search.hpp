@@ -0,0 +1,245 @@
+#ifndef RANGES_FUZZY_SEARCH_HPP
+#define RANGES_FUZZY_SEARCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fuzzy
+{
+    //////////////////////////////////////////////////////////////////
+    // classic dynamic programming - O(n * m), any length
+    inline std::size_t levenshtein_distance(std::string_view a, std::string_view b)
+    {
+        std::vector<std::size_t> row(b.size() + 1);
+        std::iota(row.begin(), row.end(), 0);
+
+        for (std::size_t i = 1; i <= a.size(); ++i)
+        {
+            std::size_t diagonal = row[0];
+            row[0] = i;
+
+            for (std::size_t j = 1; j <= b.size(); ++j)
+            {
+                const std::size_t up = row[j];
+                row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] != b[j - 1])});
+                diagonal = up;
+            }
+        }
+
+        return row[b.size()];
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // Myers/Hyyro bit-parallel edit distance
+    //   * pattern is encoded once as per-character bit masks (up to 64 chars)
+    //   * one text character is processed per iteration - all cells of a DP column
+    //     are updated at once with 64-bit word operations
+    class BitParallelPattern
+    {
+        std::array<std::uint64_t, 256> peq_{};
+        std::string_view pattern_;
+
+    public:
+        static constexpr std::size_t max_length = 64;
+
+        explicit BitParallelPattern(std::string_view pattern)
+            : pattern_{pattern}
+        {
+            for (std::size_t i = 0; i < pattern.size() && i < max_length; ++i)
+                peq_[static_cast<unsigned char>(pattern[i])] |= 1ull << i;
+        }
+
+        std::string_view pattern() const
+        {
+            return pattern_;
+        }
+
+        std::size_t distance(std::string_view text) const
+        {
+            const std::size_t m = pattern_.size();
+
+            if (m == 0)
+                return text.size();
+
+            if (m > max_length)
+                return levenshtein_distance(pattern_, text);
+
+            const std::uint64_t last = 1ull << (m - 1);
+            std::uint64_t pv = m == 64 ? ~0ull : (1ull << m) - 1;
+            std::uint64_t mv = 0;
+            std::size_t score = m;
+
+            for (char c : text)
+            {
+                const std::uint64_t eq = peq_[static_cast<unsigned char>(c)];
+                const std::uint64_t xv = eq | mv;
+                const std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+
+                std::uint64_t ph = mv | ~(xh | pv);
+                std::uint64_t mh = pv & xh;
+
+                if (ph & last)
+                    ++score;
+                else if (mh & last)
+                    --score;
+
+                ph = (ph << 1) | 1; // first row of the DP matrix grows by 1 in every column
+                mh <<= 1;
+
+                pv = mh | ~(xv | ph);
+                mv = ph & xv;
+            }
+
+            return score;
+        }
+    };
+
+    inline std::size_t edit_distance(std::string_view a, std::string_view b)
+    {
+        return BitParallelPattern{a}.distance(b);
+    }
+
+    //////////////////////////////////////////////////////////////////
+    // BK-tree over a compact copy of the dictionary
+    //   * words are stored in one char buffer, nodes in one flat vector
+    //   * children of a node form a singly linked list of siblings
+    //   * triangle inequality prunes subtrees: only edges in [d - k, d + k] are followed
+    class BkTree
+    {
+        static constexpr std::uint32_t none = UINT32_MAX;
+
+        struct Node
+        {
+            std::uint32_t offset;
+            std::uint32_t length;
+            std::uint32_t first_child = none;
+            std::uint32_t next_sibling = none;
+            std::uint32_t distance_to_parent = 0;
+        };
+
+        std::vector<char> chars_;
+        std::vector<Node> nodes_;
+
+        std::string_view word(const Node& node) const
+        {
+            return {chars_.data() + node.offset, node.length};
+        }
+
+        void insert(std::string_view word)
+        {
+            chars_.insert(chars_.end(), word.begin(), word.end());
+            nodes_.push_back(Node{static_cast<std::uint32_t>(chars_.size() - word.size()), static_cast<std::uint32_t>(word.size())});
+
+            const std::uint32_t inserted = static_cast<std::uint32_t>(nodes_.size() - 1);
+
+            if (inserted == 0)
+                return;
+
+            const BitParallelPattern pattern{word};
+            std::uint32_t current = 0;
+
+            while (true)
+            {
+                const auto d = static_cast<std::uint32_t>(pattern.distance(this->word(nodes_[current])));
+
+                if (d == 0) // duplicate
+                {
+                    nodes_.pop_back();
+                    chars_.resize(chars_.size() - word.size());
+                    return;
+                }
+
+                std::uint32_t child = nodes_[current].first_child;
+                while (child != none && nodes_[child].distance_to_parent != d)
+                    child = nodes_[child].next_sibling;
+
+                if (child == none)
+                {
+                    nodes_[inserted].distance_to_parent = d;
+                    nodes_[inserted].next_sibling = nodes_[current].first_child;
+                    nodes_[current].first_child = inserted;
+                    return;
+                }
+
+                current = child;
+            }
+        }
+
+    public:
+        struct Match
+        {
+            std::string_view word;
+            std::size_t distance;
+
+            bool operator==(const Match&) const = default;
+        };
+
+        BkTree() = default;
+
+        explicit BkTree(std::span<const std::string> dictionary)
+        {
+            std::size_t total_length = 0;
+            for (const auto& word : dictionary)
+                total_length += word.size();
+
+            chars_.reserve(total_length);
+            nodes_.reserve(dictionary.size());
+
+            for (const auto& word : dictionary)
+                insert(word);
+        }
+
+        BkTree(const BkTree&) = delete;
+        BkTree& operator=(const BkTree&) = delete;
+        BkTree(BkTree&&) = default;
+        BkTree& operator=(BkTree&&) = default;
+
+        std::size_t size() const
+        {
+            return nodes_.size();
+        }
+
+        // all words within edit distance max_distance of query (in no particular order)
+        std::vector<Match> find(std::string_view query, std::size_t max_distance) const
+        {
+            std::vector<Match> matches;
+
+            if (nodes_.empty())
+                return matches;
+
+            const BitParallelPattern pattern{query};
+            std::vector<std::uint32_t> pending{0};
+
+            while (!pending.empty())
+            {
+                const Node& node = nodes_[pending.back()];
+                pending.pop_back();
+
+                const std::size_t d = pattern.distance(word(node));
+
+                if (d <= max_distance)
+                    matches.push_back(Match{word(node), d});
+
+                const std::size_t low = d > max_distance ? d - max_distance : 0;
+                const std::size_t high = d + max_distance;
+
+                for (std::uint32_t child = node.first_child; child != none; child = nodes_[child].next_sibling)
+                {
+                    const std::size_t edge = nodes_[child].distance_to_parent;
+                    if (edge >= low && edge <= high)
+                        pending.push_back(child);
+                }
+            }
+
+            return matches;
+        }
+    };
+}
+
+#endif //RANGES_FUZZY_SEARCH_HPP